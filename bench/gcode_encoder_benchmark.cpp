@@ -0,0 +1,73 @@
+// Mikro-Benchmark: G-Code-Kodierung über QString::arg() (bisheriger Weg)
+// im Vergleich zum allokationsfreien GCodeEncoder.
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QString>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "gcode_encoder.h"
+
+namespace {
+
+struct Move {
+    double x, y, z, feedrate;
+};
+
+std::vector<Move> createMoves(int count) {
+    std::vector<Move> moves;
+    moves.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        moves.push_back(Move{(i % 100) * 2.54, (i / 100) * 2.54, (i % 3) * 0.5, 3000.0 + i % 7});
+    }
+    return moves;
+}
+
+// Verhindert, dass der Compiler die Ergebnisse wegoptimiert
+volatile std::size_t sink = 0;
+
+double benchmarkQString(const std::vector<Move> &moves) {
+    QElapsedTimer timer;
+    timer.start();
+    for (const Move &move : moves) {
+        QString command = QString("G1 X%1 Y%2 Z%3 F%4")
+            .arg(move.x, 0, 'f', 3)
+            .arg(move.y, 0, 'f', 3)
+            .arg(move.z, 0, 'f', 3)
+            .arg(move.feedrate, 0, 'f', 0);
+        QByteArray data = (command + "\n").toUtf8();
+        sink = sink + std::size_t(data.size());
+    }
+    return timer.nsecsElapsed() / double(moves.size());
+}
+
+double benchmarkEncoder(const std::vector<Move> &moves) {
+    QElapsedTimer timer;
+    timer.start();
+    GCodeCommand command;
+    for (const Move &move : moves) {
+        GCodeEncoder::linearMove(command, move.x, move.y, move.z, move.feedrate);
+        sink = sink + command.length;
+    }
+    return timer.nsecsElapsed() / double(moves.size());
+}
+
+}
+
+int main(int argc, char *argv[]) {
+    int count = argc > 1 ? std::atoi(argv[1]) : 1000000;
+    std::vector<Move> moves = createMoves(count);
+
+    // Aufwärmen
+    benchmarkQString(moves);
+    benchmarkEncoder(moves);
+
+    double qstringNs = benchmarkQString(moves);
+    double encoderNs = benchmarkEncoder(moves);
+
+    std::printf("QString::arg + toUtf8: %8.1f ns/Befehl\n", qstringNs);
+    std::printf("GCodeEncoder:          %8.1f ns/Befehl\n", encoderNs);
+    std::printf("Faktor:                %8.1fx\n", encoderNs > 0.0 ? qstringNs / encoderNs : 0.0);
+    return 0;
+}
@@ -0,0 +1,158 @@
+// Durchsatz-Benchmark des Bewegungsstapels gegen die virtuelle Firmware.
+// Misst Befehle pro Sekunde, Latenz bis zum "ok" und Planer-Unterläufe für
+// eine Lötpunktfolge und einen dicht abgetasteten Pfad.
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <cmath>
+#include <cstdio>
+#include "job_manager.h"
+#include "motion_controller.h"
+#include "virtual_firmware.h"
+
+namespace {
+
+struct BenchmarkOptions {
+    int points = 2000;
+    int pathPoints = 5000;
+    int dwellMs = 0;
+    int boards = 3;
+    int boardPoints = 200;
+    double timeScale = 20.0;
+};
+
+BenchmarkOptions parseOptions(const QStringList &arguments) {
+    BenchmarkOptions options;
+    for (int i = 1; i + 1 < arguments.size(); i += 2) {
+        const QString &option = arguments[i];
+        const QString &value = arguments[i + 1];
+        if (option == "--points") options.points = value.toInt();
+        else if (option == "--path-points") options.pathPoints = value.toInt();
+        else if (option == "--dwell-ms") options.dwellMs = value.toInt();
+        else if (option == "--boards") options.boards = value.toInt();
+        else if (option == "--board-points") options.boardPoints = value.toInt();
+        else if (option == "--time-scale") options.timeScale = value.toDouble();
+    }
+    return options;
+}
+
+QVector<SolderPoint> createBoard(int count, int dwellMs) {
+    // Raster mit 2,54 mm Abstand wie bei einer dicht bestückten Platine
+    QVector<SolderPoint> points;
+    int columns = std::max(1, int(std::sqrt(double(count))));
+    for (int i = 0; i < count; ++i) {
+        SolderPoint point;
+        point.position = QVector3D((i % columns) * 2.54f, (i / columns) * 2.54f, 0.0f);
+        point.temperature = 350.0;
+        point.dwellTime = dwellMs;
+        point.type = "SMD";
+        point.completed = false;
+        points.append(point);
+    }
+    return points;
+}
+
+QVector<QVector3D> createPath(int count) {
+    // Spirale aus kurzen Segmenten, wie sie beim Teach-In aufgezeichnet wird
+    QVector<QVector3D> path;
+    for (int i = 0; i < count; ++i) {
+        double angle = i * 0.02;
+        double radius = 20.0 + i * 0.002;
+        path.append(QVector3D(50.0 + radius * std::cos(angle),
+                              50.0 + radius * std::sin(angle), 5.0f));
+    }
+    return path;
+}
+
+bool waitUntilIdle(MotionController &controller, int timeoutMs) {
+    QElapsedTimer timer;
+    timer.start();
+    while (timer.elapsed() < timeoutMs) {
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 5);
+        GCodeSenderStatistics stats = controller.senderStatistics();
+        if (controller.queueDepth() == 0 && stats.linesInFlight == 0 &&
+            stats.linesSent == stats.linesQueued && stats.linesQueued > 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void report(const char *name, const GCodeSenderStatistics &stats, double seconds,
+            const VirtualFirmwareStatistics &before, const VirtualFirmwareStatistics &after) {
+    std::printf("%-18s %8llu Zeilen  %9llu Bytes  %9.0f Zeilen/s  "
+                "Latenz p50 %6llu µs  p99 %6llu µs  max %6llu µs  Unterläufe %llu\n",
+                name,
+                static_cast<unsigned long long>(stats.linesAcknowledged),
+                static_cast<unsigned long long>(stats.bytesSent),
+                seconds > 0.0 ? stats.linesAcknowledged / seconds : 0.0,
+                static_cast<unsigned long long>(stats.latencyP50Us),
+                static_cast<unsigned long long>(stats.latencyP99Us),
+                static_cast<unsigned long long>(stats.latencyMaxUs),
+                static_cast<unsigned long long>(after.plannerUnderruns - before.plannerUnderruns));
+}
+
+}
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    BenchmarkOptions options = parseOptions(app.arguments());
+
+    VirtualFirmwareSettings firmwareSettings;
+    firmwareSettings.timeScale = options.timeScale;
+    VirtualFirmware firmware(firmwareSettings);
+    if (!firmware.start()) {
+        return 1;
+    }
+
+    MotionController controller;
+    controller.setPortName(QString::fromStdString(firmware.portName()));
+    if (!controller.initialize()) {
+        std::fprintf(stderr, "Verbindung zur virtuellen Firmware fehlgeschlagen\n");
+        return 1;
+    }
+    waitUntilIdle(controller, 5000);
+
+    // Lötpunktfolge
+    controller.resetSenderStatistics();
+    VirtualFirmwareStatistics before = firmware.statistics();
+    QElapsedTimer timer;
+    timer.start();
+    controller.executeSolderSequence(createBoard(options.points, options.dwellMs));
+    bool finished = waitUntilIdle(controller, 600000);
+    report("Lötpunktfolge", controller.senderStatistics(), timer.nsecsElapsed() / 1e9,
+           before, firmware.statistics());
+
+    // Dicht abgetasteter Pfad
+    controller.resetSenderStatistics();
+    before = firmware.statistics();
+    timer.restart();
+    controller.moveAlongPath(createPath(options.pathPoints));
+    finished = waitUntilIdle(controller, 600000) && finished;
+    report("Pfad", controller.senderStatistics(), timer.nsecsElapsed() / 1e9,
+           before, firmware.statistics());
+
+    // Mitlaufendes Löten mehrerer Platinen auf dem fahrenden Band
+    ConveyorTrackingSettings tracking;
+    tracking.conveyorSpeed = 5.0;
+    controller.setConveyorTracking(tracking);
+    QVector<SolderPoint> board = createBoard(options.boardPoints, options.dwellMs);
+    double boardPitch = 60.0; // Bandweg zwischen zwei Platinen (mm)
+
+    controller.resetSenderStatistics();
+    before = firmware.statistics();
+    timer.restart();
+    for (int i = 0; i < options.boards; ++i) {
+        controller.executeTrackedSequence(board, boardPitch * i);
+    }
+    finished = waitUntilIdle(controller, 600000) && finished;
+    report("Mitlaufend", controller.senderStatistics(), timer.nsecsElapsed() / 1e9,
+           before, firmware.statistics());
+    std::printf("Bandweg: %.1f mm\n", controller.conveyorPosition());
+
+    VirtualFirmwareStatistics total = firmware.statistics();
+    std::printf("RX-Überläufe: %llu\n", static_cast<unsigned long long>(total.rxOverflows));
+
+    firmware.stop();
+    return finished && total.rxOverflows == 0 ? 0 : 1;
+}
@@ -0,0 +1,148 @@
+// Mikro-Benchmark: Vorverarbeitung über GaussianBlur, convertScaleAbs und
+// cvtColor (bisheriger Weg) im Vergleich zum FusedPreprocessor, bei 720p, bei
+// der Auflösung eines ganzen Platinenbildes und für Ausschnitte um die
+// Lötstellen, wie sie VisionSystem::analyzeSolderJoints() auswertet.
+//
+// Aufruf: preprocess_benchmark [Wiederholungen] [Breite Höhe]
+
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "fused_preprocessor.h"
+
+namespace {
+
+// Wie VisionSystem::DefaultJointRoiSize
+constexpr int JointRoiSize = 64;
+
+struct Resolution {
+    const char *name;
+    cv::Size size;
+};
+
+// Leiterplattenähnliches Testbild: Rauschen mit hellen Lötstellen
+cv::Mat createImage(cv::Size size) {
+    cv::Mat image(size, CV_8UC3);
+    cv::randu(image, cv::Scalar::all(20), cv::Scalar::all(120));
+    for (int y = 16; y < size.height; y += 48) {
+        for (int x = 16; x < size.width; x += 48) {
+            cv::circle(image, cv::Point(x, y), 8, cv::Scalar(200, 210, 230), cv::FILLED);
+        }
+    }
+    return image;
+}
+
+template <typename Filter>
+double measure(const cv::Mat &input, cv::Mat &output, int iterations, Filter filter) {
+    // Aufwärmen, belegt auch den Ausgabepuffer
+    filter(input, output);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        filter(input, output);
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::milli>(elapsed).count() / iterations;
+}
+
+void printResult(const char *name, cv::Size size, double chainMs, double fusedMs,
+                 double maxDifference, double meanDifference) {
+    std::printf("%-8s %4dx%-4d  Kette: %7.2f ms  Fused: %7.2f ms  Faktor: %5.2fx  "
+                "Abweichung: max %3.0f, mittel %.3f\n",
+                name, size.width, size.height,
+                chainMs, fusedMs, fusedMs > 0.0 ? chainMs / fusedMs : 0.0,
+                maxDifference, meanDifference);
+}
+
+void run(const Resolution &resolution, int iterations) {
+    cv::Mat input = createImage(resolution.size);
+    cv::Mat chain, fused;
+
+    double chainMs = measure(input, chain, iterations, [](const cv::Mat &in, cv::Mat &out) {
+        FusedPreprocessor::reference(in, out);
+    });
+    double fusedMs = measure(input, fused, iterations, [](const cv::Mat &in, cv::Mat &out) {
+        FusedPreprocessor::apply(in, out);
+    });
+
+    cv::Mat difference;
+    cv::absdiff(chain, fused, difference);
+    double maxDifference = 0.0;
+    cv::minMaxLoc(difference, nullptr, &maxDifference);
+
+    printResult(resolution.name, resolution.size, chainMs, fusedMs, maxDifference,
+                cv::mean(difference)[0]);
+}
+
+// Ausschnitte auf dem Raster der Lötstellen, auch am Bildrand angeschnitten;
+// an den Schnittkanten liest der Filter die Nachbarn aus dem Gesamtbild
+void runRegions(cv::Size size, int roiSize, int iterations) {
+    cv::Mat input = createImage(size);
+    const cv::Rect bounds(0, 0, size.width, size.height);
+    std::vector<cv::Mat> regions;
+    for (int y = 16; y < size.height; y += 48) {
+        for (int x = 16; x < size.width; x += 48) {
+            cv::Rect region = cv::Rect(x - roiSize / 2, y - roiSize / 2, roiSize, roiSize) & bounds;
+            regions.push_back(input(region));
+        }
+    }
+    std::vector<cv::Mat> chain(regions.size());
+    std::vector<cv::Mat> fused(regions.size());
+
+    auto all = [&regions](std::vector<cv::Mat> &outputs, void (*filter)(const cv::Mat &, cv::Mat &, double)) {
+        for (std::size_t i = 0; i < regions.size(); ++i) {
+            filter(regions[i], outputs[i], FusedPreprocessor::DefaultGain);
+        }
+    };
+    cv::Mat unused;
+    double chainMs = measure(input, unused, iterations, [&](const cv::Mat &, cv::Mat &) {
+        all(chain, &FusedPreprocessor::reference);
+    });
+    double fusedMs = measure(input, unused, iterations, [&](const cv::Mat &, cv::Mat &) {
+        all(fused, &FusedPreprocessor::apply);
+    });
+
+    double maxDifference = 0.0;
+    double meanDifference = 0.0;
+    for (std::size_t i = 0; i < regions.size(); ++i) {
+        cv::Mat difference;
+        cv::absdiff(chain[i], fused[i], difference);
+        double regionMax = 0.0;
+        cv::minMaxLoc(difference, nullptr, &regionMax);
+        maxDifference = std::max(maxDifference, regionMax);
+        meanDifference += cv::mean(difference)[0] / double(regions.size());
+    }
+
+    char name[32];
+    std::snprintf(name, sizeof(name), "%zux ROI", regions.size());
+    printResult(name, cv::Size(roiSize, roiSize), chainMs, fusedMs, maxDifference, meanDifference);
+}
+
+}
+
+int main(int argc, char *argv[]) {
+    int iterations = argc > 1 ? std::atoi(argv[1]) : 50;
+    if (iterations <= 0) {
+        std::fprintf(stderr, "Aufruf: %s [Wiederholungen] [Breite Höhe]\n", argv[0]);
+        return 1;
+    }
+
+    std::vector<Resolution> resolutions = {
+        {"720p", cv::Size(1280, 720)},
+        {"Platine", cv::Size(3840, 2160)},
+    };
+    if (argc > 3) {
+        resolutions.push_back({"Eigene", cv::Size(std::atoi(argv[2]), std::atoi(argv[3]))});
+    }
+
+    // Einzelthread, damit beide Wege gleich behandelt werden
+    cv::setNumThreads(1);
+    for (const Resolution &resolution : resolutions) {
+        run(resolution, iterations);
+    }
+    runRegions(resolutions.front().size, JointRoiSize, iterations);
+    return 0;
+}
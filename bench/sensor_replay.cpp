@@ -0,0 +1,177 @@
+// Aufzeichnung und Wiedergabe von Sensordaten für Regressionsläufe.
+//
+//   sensor_replay --record <datei> [--seconds 60] [--seed 5489] [--speed 1]
+//   sensor_replay --replay <datei> [--speed 10] [--obstacle-on 50]
+//                 [--obstacle-off 60] [--obstacle-debounce-ms 20]
+//
+// Beim Aufzeichnen liefert die Simulation mit festem Startwert die Werte, im
+// Betrieb schreibt dieselbe Funktion (SensorManager::startRecording) eine
+// Schicht an der Maschine mit. Die Wiedergabe läuft über SensorManager und
+// SecuritySystem wie im Betrieb; ScaledClock rafft die Zeit, die
+// Entprellung rechnet weiter in aufgezeichneter Zeit. Ausgegeben werden
+// die Meldungen und die Latenzen der Abtastaufgaben, so dass neue Filter-
+// und Sicherheitslogik gegen dieselben Daten verglichen werden kann.
+
+#include <QCoreApplication>
+#include <QTimer>
+#include <cstdio>
+#include "loop_instrumentation.h"
+#include "security_system.h"
+#include "sensor_manager.h"
+#include "sensor_recording.h"
+
+namespace {
+
+constexpr std::int64_t NanosecondsPerSecond = 1000000000;
+constexpr qint64 NsPerMs = 1000000;
+// Abstand, in dem das Ende eines Laufs geprüft wird (ms Wanduhr)
+constexpr int PollIntervalMs = 20;
+
+struct ReplayOptions {
+    QString recordPath;
+    QString replayPath;
+    double seconds = 60.0;
+    double speed = 0.0;             // 0: Aufzeichnung in Echtzeit, Wiedergabe 10x
+    quint32 seed = SimulatedSensorSource::DefaultSeed;
+    double obstacleOn = 50.0;
+    double obstacleOff = 60.0;
+    double obstacleDebounceMs = 20.0;
+};
+
+ReplayOptions parseOptions(const QStringList &arguments) {
+    ReplayOptions options;
+    for (int i = 1; i + 1 < arguments.size(); i += 2) {
+        const QString &option = arguments[i];
+        const QString &value = arguments[i + 1];
+        if (option == "--record") options.recordPath = value;
+        else if (option == "--replay") options.replayPath = value;
+        else if (option == "--seconds") options.seconds = value.toDouble();
+        else if (option == "--speed") options.speed = value.toDouble();
+        else if (option == "--seed") options.seed = value.toUInt();
+        else if (option == "--obstacle-on") options.obstacleOn = value.toDouble();
+        else if (option == "--obstacle-off") options.obstacleOff = value.toDouble();
+        else if (option == "--obstacle-debounce-ms") options.obstacleDebounceMs = value.toDouble();
+    }
+    return options;
+}
+
+void printProbes(SensorManager &sensors) {
+    for (LoopProbe *probe : sensors.loopProbes()) {
+        LoopStatistics statistics = probe->statistics();
+        std::printf("%-14s Verspätung p99 %8.1f µs  max %8.1f µs  Rechenzeit p99 %6.1f µs",
+                    probe->name(), statistics.lateness.p99, statistics.lateness.maximum,
+                    statistics.execution.p99);
+        if (statistics.latency.count > 0) {
+            std::printf("  Meldung p50 %6.1f µs  p99 %6.1f µs",
+                        statistics.latency.p50, statistics.latency.p99);
+        }
+        std::printf("\n");
+    }
+}
+
+int record(QCoreApplication &app, const ReplayOptions &options) {
+    ScaledClock clock(options.speed > 0.0 ? options.speed : 1.0);
+    SimulatedSensorSource source(options.seed);
+
+    SensorManager sensors;
+    sensors.setClock(&clock);
+    sensors.setSensorSource(&source);
+    SecuritySystem security;
+    security.setSensorSource(&source, &clock);
+    QObject::connect(&security, &SecuritySystem::smokeMeasured, &sensors,
+                     [&sensors](double level, qint64 timestampNs) {
+        sensors.recordSample(SensorId::Smoke, level, timestampNs);
+    });
+
+    if (!sensors.startRecording(options.recordPath) || !sensors.initialize()) {
+        return 1;
+    }
+
+    std::int64_t endNs = clock.nowNs() + std::int64_t(options.seconds * NanosecondsPerSecond);
+    QTimer poll;
+    QObject::connect(&poll, &QTimer::timeout, &app, [&]() {
+        if (clock.nowNs() >= endNs) app.quit();
+    });
+    poll.start(PollIntervalMs);
+    app.exec();
+
+    sensors.stopRecording();
+    std::printf("%s: %.1f s aufgezeichnet, %llu verworfene Messwerte\n",
+                qPrintable(options.recordPath), options.seconds,
+                static_cast<unsigned long long>(sensors.droppedSamples()));
+    return 0;
+}
+
+int replay(QCoreApplication &app, const ReplayOptions &options) {
+    SensorReplaySource source;
+    if (!source.load(options.replayPath)) {
+        return 1;
+    }
+
+    ScaledClock clock(options.speed > 0.0 ? options.speed : 10.0);
+
+    HysteresisSettings obstacle;
+    obstacle.activateThreshold = options.obstacleOn;
+    obstacle.releaseThreshold = options.obstacleOff;
+    obstacle.activeBelow = true;
+    obstacle.activateDebounceNs = std::int64_t(options.obstacleDebounceMs * NsPerMs);
+    obstacle.releaseDebounceNs = 300 * NsPerMs;
+
+    SensorManager sensors;
+    sensors.setClock(&clock);
+    sensors.setSensorSource(&source);
+    sensors.setObstacleHysteresis(obstacle);
+    SecuritySystem security;
+    security.setSensorSource(&source, &clock);
+
+    // Die Wiedergabe beginnt mit der ersten Abtastung, so liegt das Raster
+    // des Sensorthreads bei jedem Lauf gleich auf der Aufzeichnung
+    std::int64_t startNs = clock.nowNs();
+    auto elapsed = [&]() { return double(clock.nowNs() - startNs) / NanosecondsPerSecond; };
+
+    int obstacleEvents = 0;
+    int componentEvents = 0;
+    int smokeAlarms = 0;
+    QObject::connect(&sensors, &SensorManager::obstacleDetected, &app, [&](bool detected) {
+        ++obstacleEvents;
+        std::printf("%10.3f s  Hindernis %s\n", elapsed(), detected ? "erkannt" : "frei");
+    });
+    QObject::connect(&sensors, &SensorManager::componentDetected, &app, [&](bool) {
+        ++componentEvents;
+    });
+    QObject::connect(&security, &SecuritySystem::smokeDetected, &app, [&](double level) {
+        ++smokeAlarms;
+        std::printf("%10.3f s  Rauch %.2f\n", elapsed(), level);
+    });
+
+    if (!sensors.initialize()) {
+        return 1;
+    }
+
+    QTimer poll;
+    QObject::connect(&poll, &QTimer::timeout, &app, [&]() {
+        if (source.finished(clock.nowNs())) app.quit();
+    });
+    poll.start(PollIntervalMs);
+    app.exec();
+
+    std::printf("\n%s: %.1f s mit Faktor %.1f wiedergegeben, %llu Messwerte\n",
+                qPrintable(options.replayPath), source.durationNs() / double(NanosecondsPerSecond),
+                clock.speed(), static_cast<unsigned long long>(source.sampleCount()));
+    std::printf("Hindernismeldungen %d, Bauteilmeldungen %d, Rauchalarme %d\n",
+                obstacleEvents, componentEvents, smokeAlarms);
+    printProbes(sensors);
+    return 0;
+}
+}
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    ReplayOptions options = parseOptions(app.arguments());
+
+    if (!options.recordPath.isEmpty()) return record(app, options);
+    if (!options.replayPath.isEmpty()) return replay(app, options);
+
+    std::fprintf(stderr, "Aufruf: sensor_replay --record <datei> | --replay <datei> [Optionen]\n");
+    return 2;
+}
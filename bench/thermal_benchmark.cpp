@@ -0,0 +1,343 @@
+// Vergleich der Regelvarianten der Lötspitzenheizung an der simulierten
+// Strecke. Regelthread und Uhr werden durch SimulatedClock und
+// SimulatedThermalPlant ersetzt, eine ganze Platine läuft in Millisekunden.
+// Gemessen werden Einschwingzeit und Überschwingen beim Aufheizen sowie
+// Wartezeit, Temperatureinbruch und gesamte Verweilzeit an den Lötpunkten.
+//
+// Aufgezeichnete Programme (ProgramManager-Format) mit --profile <datei.json>.
+// Jedes Profil läuft zusätzlich in der Reihenfolge von
+// JobManager::optimizePointSequence(); dessen vorhergesagte Taktzeit lässt
+// sich so mit der simulierten Laufzeit vergleichen.
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include "job_manager.h"
+#include "temperature_control.h"
+
+namespace {
+
+constexpr std::int64_t NanosecondsPerSecond = 1000000000;
+
+struct BenchmarkOptions {
+    QStringList profiles;
+    int points = 200;
+    int rateHz = 50;
+    double tolerance = 3.0;         // Zulässige Abweichung der Spitze (K)
+    double travelSpeed = 100.0;     // mm/s zwischen den Punkten
+    double approachTime = 0.3;      // Absenken und Anheben (s)
+    double warmUpWindow = 60.0;     // Auswertefenster des Aufheizens (s)
+    double maxWait = 30.0;          // Abbruch, wenn die Spitze nicht einschwingt (s)
+};
+
+BenchmarkOptions parseOptions(const QStringList &arguments) {
+    BenchmarkOptions options;
+    for (int i = 1; i + 1 < arguments.size(); i += 2) {
+        const QString &option = arguments[i];
+        const QString &value = arguments[i + 1];
+        if (option == "--profile") options.profiles.append(value);
+        else if (option == "--points") options.points = value.toInt();
+        else if (option == "--rate") options.rateHz = value.toInt();
+        else if (option == "--tolerance") options.tolerance = value.toDouble();
+        else if (option == "--travel-speed") options.travelSpeed = value.toDouble();
+    }
+    return options;
+}
+
+struct JobProfile {
+    QString name;
+    QVector<SolderPoint> points;
+};
+
+SolderPoint makePoint(double x, double y, double temperature, int dwellMs, const QString &type) {
+    SolderPoint point;
+    point.position = QVector3D(float(x), float(y), 0.0f);
+    point.temperature = temperature;
+    point.dwellTime = dwellMs;
+    point.type = type;
+    point.completed = false;
+    return point;
+}
+
+JobProfile smdProfile(int count) {
+    JobProfile profile{"SMD", {}};
+    int columns = std::max(1, int(std::sqrt(double(count))));
+    for (int i = 0; i < count; ++i) {
+        profile.points.append(makePoint((i % columns) * 2.54, (i / columns) * 2.54, 330.0, 800, "SMD"));
+    }
+    return profile;
+}
+
+JobProfile mixedProfile(int count) {
+    // Steckerleisten (PTH, heißer und länger) zwischen SMD-Gruppen
+    JobProfile profile{"Gemischt", {}};
+    for (int i = 0; i < count; ++i) {
+        bool through = (i / 10) % 3 == 2;
+        profile.points.append(makePoint((i % 40) * 2.54, (i / 40) * 10.0,
+                                        through ? 370.0 : 330.0, through ? 1500 : 800,
+                                        through ? "PTH" : "SMD"));
+    }
+    return profile;
+}
+
+bool loadProfile(const QString &path, JobProfile &profile) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        std::fprintf(stderr, "Profil %s: %s\n", qPrintable(path), qPrintable(file.errorString()));
+        return false;
+    }
+
+    QJsonObject program = QJsonDocument::fromJson(file.readAll()).object();
+    profile.name = program["name"].toString(QFileInfo(path).baseName());
+    for (const auto &value : program["points"].toArray()) {
+        QJsonObject point = value.toObject();
+        profile.points.append(makePoint(point["x"].toDouble(), point["y"].toDouble(),
+                                        point["temperature"].toDouble(), point["dwellTime"].toInt(),
+                                        point["type"].toString()));
+    }
+    return !profile.points.isEmpty();
+}
+
+PadLoad padFor(const SolderPoint &point) {
+    PadLoad pad;
+    if (point.type == "PTH") {
+        pad.contactConductance = 0.08;
+        pad.capacity = 0.8;
+        pad.boardConductance = 0.05;
+    }
+    return pad;
+}
+
+// Reihenfolge wie beim Jobstart, mit dem Wärmemodell der simulierten Strecke
+JobProfile sequencedProfile(const JobProfile &profile, const BenchmarkOptions &options) {
+    PlantParameters plant;
+    SequencingSettings settings;
+    settings.temperatureTolerance = options.tolerance;
+    settings.travelSpeed = options.travelSpeed;
+    settings.approachTime = options.approachTime;
+    settings.heater.heaterPower = plant.heaterPower;
+    settings.heater.heatCapacity = plant.heaterCapacity + plant.tipCapacity;
+    settings.heater.lossCoefficient = plant.ambientLoss;
+    settings.heater.ambientTemperature = plant.ambientTemperature;
+
+    JobManager jobs;
+    jobs.setSequencingSettings(settings);
+    JobProfile sequenced{profile.name + " sortiert", profile.points};
+    SequencingReport report = jobs.optimizePointSequence(sequenced.points);
+    std::printf("%-10s Reihenfolge %-16s Taktzeit %7.1f s (Nearest-Neighbor %7.1f s)  "
+                "Temperaturwechsel %d statt %d\n",
+                qPrintable(profile.name),
+                report.mode == SequencingMode::TransitionTime ? "nach Übergangszeit" : "Nearest-Neighbor",
+                report.cycleTime, report.nearestNeighbourCycleTime,
+                report.temperatureChanges, report.nearestNeighbourTemperatureChanges);
+    return sequenced;
+}
+
+struct Variant {
+    const char *name;
+    bool preBoost;
+    bool tuned;
+};
+
+struct Metrics {
+    double settleTime = 0.0;    // Aufheizen: letzter Austritt aus dem Toleranzband (s)
+    double overshoot = 0.0;     // Aufheizen: größte Überschreitung (K)
+    double waitTime = 0.0;      // Summe der Wartezeiten vor dem Aufsetzen (s)
+    double dwellTime = 0.0;     // Wartezeit und Kontaktzeit aller Punkte (s)
+    double maxDip = 0.0;        // Größter Einbruch unter die Löttemperatur im Kontakt (K)
+    double jobTime = 0.0;       // Simulierte Laufzeit der Platine ohne Aufheizen (s)
+    int timeouts = 0;
+    double wallMs = 0.0;
+};
+
+// Simulation einer Variante mit eigener Uhr und Strecke
+class Simulation {
+public:
+    Simulation(const BenchmarkOptions &options, const Variant &variant, const PIDGains &gains)
+        : options(options)
+    {
+        control.setClock(&clock);
+        control.setHeaterInterface(&plant);
+        control.setControlRate(options.rateHz);
+
+        PreBoostSettings preBoost;
+        preBoost.enabled = variant.preBoost;
+        control.setPreBoostSettings(preBoost);
+        control.setPIDGains(gains);
+    }
+
+    double seconds() const { return double(clock.nowNs()) / NanosecondsPerSecond; }
+    double tip() const { return plant.tipTemperature(); }
+
+    void step() {
+        control.runSimulation(1.0 / options.rateHz);
+    }
+
+    void run(double duration) {
+        double end = seconds() + duration;
+        while (seconds() < end) step();
+    }
+
+    Metrics runJob(const JobProfile &profile) {
+        Metrics metrics;
+        if (profile.points.isEmpty()) return metrics;
+
+        // Aufheizen auf die erste Löttemperatur
+        double target = profile.points.first().temperature;
+        control.setTargetTemperature(target);
+        control.enableHeating(true);
+        double start = seconds();
+        while (seconds() - start < options.warmUpWindow) {
+            step();
+            double deviation = tip() - target;
+            metrics.overshoot = std::max(metrics.overshoot, deviation);
+            if (std::abs(deviation) > options.tolerance) {
+                metrics.settleTime = seconds() - start;
+            }
+        }
+
+        double jobStart = seconds();
+        QVector3D position = profile.points.first().position;
+        for (int i = 0; i < profile.points.size(); ++i) {
+            const SolderPoint &point = profile.points[i];
+            double travel = position.distanceToPoint(point.position) / options.travelSpeed +
+                            options.approachTime;
+            position = point.position;
+
+            // Der Lötplan wird vor jeder Anfahrt mit den Schätzzeiten neu übergeben
+            QVector<SolderPoint> remaining = profile.points.mid(i);
+            QVector<double> contactTimes;
+            double eta = travel;
+            QVector3D from = point.position;
+            for (const SolderPoint &next : remaining) {
+                eta += from.distanceToPoint(next.position) / options.travelSpeed;
+                contactTimes.append(eta);
+                eta += next.dwellTime / 1000.0 + options.approachTime;
+                from = next.position;
+            }
+            control.clearPlannedPoints();
+            control.planSolderPoints(remaining, contactTimes);
+
+            control.setTargetTemperature(point.temperature);
+            run(travel);
+
+            // Erst aufsetzen, wenn die Spitze im Toleranzband liegt
+            double waitStart = seconds();
+            while (std::abs(tip() - point.temperature) > options.tolerance) {
+                if (seconds() - waitStart > options.maxWait) {
+                    ++metrics.timeouts;
+                    break;
+                }
+                step();
+            }
+            double wait = seconds() - waitStart;
+
+            plant.beginContact(padFor(point), clock.nowNs());
+            double contactEnd = seconds() + point.dwellTime / 1000.0;
+            while (seconds() < contactEnd) {
+                step();
+                metrics.maxDip = std::max(metrics.maxDip, point.temperature - tip());
+            }
+            plant.endContact(clock.nowNs());
+
+            metrics.waitTime += wait;
+            metrics.dwellTime += wait + point.dwellTime / 1000.0;
+        }
+        metrics.jobTime = seconds() - jobStart;
+        return metrics;
+    }
+
+private:
+    const BenchmarkOptions &options;
+    SimulatedClock clock;
+    SimulatedThermalPlant plant;
+    TemperatureControl control;
+};
+
+// Relaisversuch an einer frischen Strecke, ohne die Ergebnisse zu speichern
+bool autotune(const BenchmarkOptions &options, double setpoint, AutotuneResult &result) {
+    SimulatedThermalPlant plant;
+    RelayAutotuner tuner;
+    tuner.start(setpoint, plant.parameters().ambientTemperature, AutotuneSettings());
+
+    std::int64_t periodNs = NanosecondsPerSecond / options.rateHz;
+    std::int64_t nowNs = 0;
+    while (tuner.isRunning()) {
+        nowNs += periodNs;
+        double power = tuner.update(plant.readTemperature(nowNs), 1.0 / options.rateHz);
+        plant.applyPower(power, nowNs);
+    }
+    result = tuner.result();
+    return result.success;
+}
+
+void report(const QString &profile, const char *variant, const Metrics &metrics) {
+    std::printf("%-10s %-24s Einschwingen %6.2f s  Überschwingen %5.1f K  Wartezeit %7.2f s  "
+                "Verweilzeit %7.2f s  Einbruch %5.1f K  Laufzeit %7.1f s  Abbrüche %d  (%.0f ms)\n",
+                qPrintable(profile), variant, metrics.settleTime, metrics.overshoot,
+                metrics.waitTime, metrics.dwellTime, metrics.maxDip, metrics.jobTime,
+                metrics.timeouts, metrics.wallMs);
+}
+
+}
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    BenchmarkOptions options = parseOptions(app.arguments());
+    options.rateHz = std::clamp(options.rateHz, 1, 1000);
+
+    QVector<JobProfile> profiles;
+    for (const QString &path : options.profiles) {
+        JobProfile profile;
+        if (loadProfile(path, profile)) profiles.append(profile);
+    }
+    if (profiles.isEmpty()) {
+        profiles.append(smdProfile(options.points));
+        profiles.append(mixedProfile(options.points));
+    }
+    for (int i = 0, count = profiles.size(); i < count; ++i) {
+        profiles.append(sequencedProfile(profiles[i], options));
+    }
+
+    AutotuneResult tuning;
+    QElapsedTimer timer;
+    timer.start();
+    bool tuned = autotune(options, profiles.first().points.first().temperature, tuning);
+    if (tuned) {
+        std::printf("Autotuning (%.0f ms): K %.2f K/%%  T %.2f s  L %.2f s  ->  kp %.3f  ki %.3f  kd %.3f\n",
+                    timer.nsecsElapsed() / 1e6, tuning.model.gain, tuning.model.timeConstant,
+                    tuning.model.deadTime, tuning.gains.kp, tuning.gains.ki, tuning.gains.kd);
+    } else {
+        std::printf("Autotuning fehlgeschlagen, Variante entfällt\n");
+    }
+
+    const Variant variants[] = {
+        {"PID", false, false},
+        {"PID + Vorsteuerung", true, false},
+        {"Autotuning", false, true},
+        {"Autotuning + Vorsteuerung", true, true},
+    };
+
+    int timeouts = 0;
+    for (const JobProfile &profile : profiles) {
+        for (const Variant &variant : variants) {
+            if (variant.tuned && !tuned) continue;
+
+            timer.restart();
+            Simulation simulation(options, variant, variant.tuned ? tuning.gains : PIDGains());
+            Metrics metrics = simulation.runJob(profile);
+            metrics.wallMs = timer.nsecsElapsed() / 1e6;
+            report(profile.name, variant.name, metrics);
+            timeouts += metrics.timeouts;
+        }
+    }
+
+    return timeouts == 0 ? 0 : 1;
+}
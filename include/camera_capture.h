@@ -0,0 +1,75 @@
+#ifndef SOLDERROBOT_CAMERA_CAPTURE_H
+#define SOLDERROBOT_CAMERA_CAPTURE_H
+
+#include <opencv2/opencv.hpp>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "lockfree_ring.h"
+#include "control_clock.h"
+
+struct CameraFrame {
+    cv::Mat image;                  // BGR, vorab in voller Größe belegt
+    std::int64_t captureNs = 0;     // Monotone Zeit, zu der grab() zurückkam
+    std::uint64_t sequence = 0;     // Fortlaufend ab 1; 0 = noch kein Bild
+};
+
+struct CameraSettings {
+    int device = 0;
+    int width = 1280;
+    int height = 720;
+    double fps = 30.0;
+};
+
+// Bildeinzug auf einem eigenen Thread.
+//
+// Der Thread holt fortlaufend Bilder in einen Dreifachpuffer aus vorab
+// belegten cv::Mat. latestFrame() liefert ohne Warten das neueste Bild, auch
+// wenn mehrere Stellen im selben Thread danach fragen; niemand nimmt einem
+// anderen ein Bild weg. Kameraeigenschaften werden zwischen zwei Bildern im
+// Aufnahmethread gesetzt, weil cv::VideoCapture nicht threadsicher ist.
+class CameraCapture {
+public:
+    CameraCapture();
+    ~CameraCapture();
+
+    bool open(const CameraSettings &settings);
+    void close();
+    bool isOpened() const;
+    cv::Size frameSize() const { return size; }
+
+    bool start();
+    void stop();
+    bool isRunning() const { return running; }
+
+    void setProperty(int property, double value);
+
+    // Nur aus einem Thread aufrufen. Die Referenz bleibt bis zum nächsten
+    // Aufruf gültig; wer das Bild länger braucht, kopiert es.
+    const CameraFrame &latestFrame();
+
+    std::uint64_t capturedFrames() const { return sequence.load(std::memory_order_relaxed); }
+    std::uint64_t failedReads() const { return failures.load(std::memory_order_relaxed); }
+
+private:
+    void run();
+    void applyPendingProperties();
+
+    cv::VideoCapture camera;
+    cv::Size size;
+    MonotonicClock clock;
+    TripleBuffer<CameraFrame> frames;
+    std::thread worker;
+    std::atomic<bool> running;
+    std::atomic<std::uint64_t> sequence;
+    std::atomic<std::uint64_t> failures;
+    // Selten geändert, daher genügt hier ein Mutex außerhalb des Bildpfads
+    std::mutex propertyMutex;
+    std::vector<std::pair<int, double>> pendingProperties;
+    std::atomic<bool> propertiesPending;
+};
+
+#endif // SOLDERROBOT_CAMERA_CAPTURE_H
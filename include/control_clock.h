@@ -0,0 +1,49 @@
+#ifndef SOLDERROBOT_CONTROL_CLOCK_H
+#define SOLDERROBOT_CONTROL_CLOCK_H
+
+#include <cstdint>
+
+// Zeitbasis der Regel- und Abtastschleifen. Im Betrieb die monotone
+// Systemuhr, in Simulationen eine Uhr, die beim Warten sofort auf die
+// Weckzeit springt.
+class ControlClock {
+public:
+    virtual ~ControlClock() = default;
+    virtual std::int64_t nowNs() const = 0;
+    virtual void sleepUntil(std::int64_t deadlineNs) = 0;
+};
+
+class MonotonicClock : public ControlClock {
+public:
+    std::int64_t nowNs() const override;
+    // Absolute Weckzeit: Rechenzeit des Zyklus verschiebt die Periode nicht
+    void sleepUntil(std::int64_t deadlineNs) override;
+};
+
+// Monotone Uhr im Zeitraffer (speed > 1) oder in Zeitlupe, z.B. für die
+// beschleunigte Wiedergabe von Sensoraufzeichnungen. Beginnt bei der
+// aktuellen monotonen Zeit; darf aus mehreren Threads gelesen werden.
+class ScaledClock : public ControlClock {
+public:
+    explicit ScaledClock(double speed = 1.0);
+    std::int64_t nowNs() const override;
+    void sleepUntil(std::int64_t deadlineNs) override;
+    double speed() const { return factor; }
+
+private:
+    MonotonicClock monotonic;
+    std::int64_t originNs;
+    double factor;
+};
+
+class SimulatedClock : public ControlClock {
+public:
+    std::int64_t nowNs() const override { return current; }
+    void sleepUntil(std::int64_t deadlineNs) override;
+    void advance(std::int64_t ns) { current += ns; }
+
+private:
+    std::int64_t current = 0;
+};
+
+#endif // SOLDERROBOT_CONTROL_CLOCK_H
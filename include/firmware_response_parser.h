@@ -0,0 +1,132 @@
+#ifndef SOLDERROBOT_FIRMWARE_RESPONSE_PARSER_H
+#define SOLDERROBOT_FIRMWARE_RESPONSE_PARSER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+// Zuletzt von der Firmware gemeldete Ist-Position
+struct MachinePosition {
+    double x = 0.0;
+    double y = 0.0;
+    double z = 0.0;
+    std::int64_t timestampNs = 0;  // Monotone Empfangszeit
+    std::uint64_t sequence = 0;    // 0 = noch keine Meldung empfangen
+};
+
+// Positions-Schnappschuss für einen Schreiber (I/O-Thread) und beliebig viele
+// Leser. Sequenzsperre: Leser wiederholen, falls während des Lesens
+// geschrieben wurde; der Schreiber wird nie blockiert.
+class AtomicMachinePosition {
+public:
+    void store(double x, double y, double z, std::int64_t timestampNs) {
+        std::uint64_t sequence = version.load(std::memory_order_relaxed);
+        version.store(sequence + 1, std::memory_order_relaxed); // Ungerade: Schreiben läuft
+        std::atomic_thread_fence(std::memory_order_release);
+        posX.store(x, std::memory_order_relaxed);
+        posY.store(y, std::memory_order_relaxed);
+        posZ.store(z, std::memory_order_relaxed);
+        timestamp.store(timestampNs, std::memory_order_relaxed);
+        version.store(sequence + 2, std::memory_order_release);
+    }
+
+    MachinePosition load() const {
+        MachinePosition position;
+        std::uint64_t before;
+        std::uint64_t after;
+        do {
+            before = version.load(std::memory_order_acquire);
+            position.x = posX.load(std::memory_order_relaxed);
+            position.y = posY.load(std::memory_order_relaxed);
+            position.z = posZ.load(std::memory_order_relaxed);
+            position.timestampNs = timestamp.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            after = version.load(std::memory_order_relaxed);
+        } while (before != after || (before & 1));
+
+        position.sequence = before / 2;
+        return position;
+    }
+
+private:
+    std::atomic<std::uint64_t> version{0};
+    std::atomic<double> posX{0.0};
+    std::atomic<double> posY{0.0};
+    std::atomic<double> posZ{0.0};
+    std::atomic<std::int64_t> timestamp{0};
+};
+
+// Inkrementeller Zeilenparser für Firmware-Antworten. Arbeitet direkt auf dem
+// Lesepuffer des seriellen Ports; nur eine über die Puffergrenze reichende
+// Restzeile wird in einen festen internen Puffer kopiert.
+class FirmwareResponseParser {
+public:
+    enum class LineType {
+        Ok,        // "ok", auch "ok T:..." (Marlin)
+        Error,     // "error..." / "Error:..."
+        Position,  // M114/M154 "X:.. Y:.. Z:.." oder Grbl "<...|MPos:x,y,z|...>";
+                   // bei Grbl "WPos:" wird der zuletzt gemeldete "WCO:" addiert
+        Other
+    };
+
+    struct Line {
+        LineType type;
+        std::string_view text;   // Nur bis zum nächsten feed()-Aufruf gültig
+        double x, y, z;          // Bei LineType::Position, Maschinenkoordinaten
+    };
+
+    static constexpr std::size_t MaxLineLength = 256;
+
+    // Ruft 'handler(const Line &)' für jede vollständige Zeile auf
+    template <typename Handler>
+    void feed(const char *data, std::size_t size, Handler &&handler) {
+        const char *end = data + size;
+        while (data < end) {
+            const char *newline = static_cast<const char *>(memchr(data, '\n', std::size_t(end - data)));
+            if (!newline) {
+                appendPartial(data, std::size_t(end - data));
+                return;
+            }
+
+            if (partialLength > 0) {
+                // Restzeile aus dem vorherigen Aufruf vervollständigen
+                appendPartial(data, std::size_t(newline - data));
+                dispatch(std::string_view(partial, partialLength), handler);
+                partialLength = 0;
+            } else {
+                dispatch(std::string_view(data, std::size_t(newline - data)), handler);
+            }
+            data = newline + 1;
+        }
+    }
+
+    void reset() {
+        partialLength = 0;
+        workOffset[0] = workOffset[1] = workOffset[2] = 0.0;
+    }
+
+    Line classify(std::string_view text);
+
+private:
+    template <typename Handler>
+    void dispatch(std::string_view text, Handler &handler) {
+        text = trim(text);
+        if (!text.empty()) {
+            handler(classify(text));
+        }
+    }
+
+    void appendPartial(const char *data, std::size_t size);
+    static std::string_view trim(std::string_view text);
+    static bool parseMarlinPosition(std::string_view text, double &x, double &y, double &z);
+    bool parseGrblStatus(std::string_view text, double &x, double &y, double &z);
+
+    char partial[MaxLineLength];
+    std::size_t partialLength = 0;
+    // Grbl meldet WCO nur gelegentlich und bei Änderungen; bis dahin gilt der letzte Wert
+    double workOffset[3] = {0.0, 0.0, 0.0};
+};
+
+#endif // SOLDERROBOT_FIRMWARE_RESPONSE_PARSER_H
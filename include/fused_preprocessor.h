@@ -0,0 +1,29 @@
+#ifndef SOLDERROBOT_FUSED_PREPROCESSOR_H
+#define SOLDERROBOT_FUSED_PREPROCESSOR_H
+
+#include <opencv2/opencv.hpp>
+
+// Vorverarbeitung der Lötstellenbilder in einem Durchlauf.
+//
+// Statt 5x5-Gauß auf drei Kanälen, Verstärkung und anschließender
+// Graustufenwandlung (drei volle Durchläufe, zwei dreikanalige
+// Zwischenbilder) wird jede Zeile sofort in Grau gewandelt und horizontal
+// gefiltert; die vertikale Filterung samt Verstärkung läuft über einen
+// Ring aus fünf Zeilen. Alle Schritte sind linear, das Ergebnis weicht vom
+// bisherigen Weg nur durch Rundung und dort ab, wo einzelne Farbkanäle
+// vorher in die Sättigung liefen.
+//
+// Ausschnitte (ROI) werden am Rand wie von GaussianBlur mit den Pixeln des
+// Gesamtbildes gefiltert. Die Zeilenpuffer sind thread_local; apply() darf
+// parallel aufgerufen werden. 'output' wird nur bei geänderter Größe neu belegt.
+class FusedPreprocessor {
+public:
+    static constexpr double DefaultGain = 1.2;
+
+    static void apply(const cv::Mat &input, cv::Mat &output, double gain = DefaultGain);
+
+    // Bisheriger Weg über GaussianBlur, convertScaleAbs und cvtColor
+    static void reference(const cv::Mat &input, cv::Mat &output, double gain = DefaultGain);
+};
+
+#endif // SOLDERROBOT_FUSED_PREPROCESSOR_H
@@ -0,0 +1,52 @@
+#ifndef SOLDERROBOT_GCODE_COMMAND_H
+#define SOLDERROBOT_GCODE_COMMAND_H
+
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+// Vorkodierte G-Code-Zeile fester Größe (inkl. abschließendem '\n'), damit
+// Befehle ohne Heap-Allokation durch die Ringpuffer gereicht werden können
+struct GCodeCommand {
+    static constexpr std::size_t MaxLength = 95;
+
+    char text[MaxLength + 1];
+    std::uint8_t length = 0;
+
+    // Zeile ohne Zeilenumbruch übernehmen; zu lange Zeilen werden abgelehnt
+    bool assign(std::string_view line) {
+        if (line.size() + 1 > MaxLength) return false;
+        std::memcpy(text, line.data(), line.size());
+        text[line.size()] = '\n';
+        length = static_cast<std::uint8_t>(line.size() + 1);
+        return true;
+    }
+
+    std::string_view view() const { return std::string_view(text, length); }
+};
+
+// Antwort der Firmware, vom I/O-Thread an die Steuerung zurückgereicht
+struct SerialResponse {
+    enum Type : std::uint8_t {
+        Acknowledged,  // "ok" zur ältesten offenen Zeile
+        Error,         // "error" zur ältesten offenen Zeile
+        Message        // Sonstige Ausgabe (z.B. Positionsberichte)
+    };
+
+    static constexpr std::size_t MaxLength = 95;
+
+    Type type = Message;
+    std::uint64_t lineNumber = 0;
+    std::int64_t latencyUs = 0;   // Zeit zwischen Senden und Bestätigung
+    char text[MaxLength + 1];
+    std::uint8_t length = 0;
+
+    void setText(std::string_view line) {
+        length = static_cast<std::uint8_t>(line.size() < MaxLength ? line.size() : MaxLength);
+        std::memcpy(text, line.data(), length);
+    }
+
+    std::string_view view() const { return std::string_view(text, length); }
+};
+
+#endif // SOLDERROBOT_GCODE_COMMAND_H
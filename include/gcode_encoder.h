@@ -0,0 +1,160 @@
+#ifndef SOLDERROBOT_GCODE_ENCODER_H
+#define SOLDERROBOT_GCODE_ENCODER_H
+
+#include <charconv>
+#include <cmath>
+#include <string_view>
+#include "gcode_command.h"
+
+// Schreibt eine G-Code-Zeile direkt in den festen Puffer eines GCodeCommand.
+// Keine Heap-Allokation; Zahlen werden mit std::to_chars formatiert.
+class GCodeLineWriter {
+public:
+    explicit GCodeLineWriter(GCodeCommand &command)
+        : target(command)
+        , position(command.text)
+        , end(command.text + GCodeCommand::MaxLength - 1) // Platz für '\n'
+        , valid(true)
+    {
+    }
+
+    // Zeichenkettenliteral; die Länge steht zur Übersetzungszeit fest
+    template <std::size_t N>
+    GCodeLineWriter &literal(const char (&text)[N]) {
+        return append(std::string_view(text, N - 1));
+    }
+
+    GCodeLineWriter &append(std::string_view text) {
+        if (!valid || std::size_t(end - position) < text.size()) {
+            valid = false;
+            return *this;
+        }
+        for (char c : text) {
+            *position++ = c;
+        }
+        return *this;
+    }
+
+    // Adresswort wie " X12.345" mit fester Nachkommastellenzahl
+    template <char Letter, int Precision>
+    GCodeLineWriter &word(double value) {
+        static_assert(Precision >= 0 && Precision <= 6, "Genauigkeit außerhalb des Bereichs");
+        if (!valid || end - position < 2) {
+            valid = false;
+            return *this;
+        }
+        *position++ = ' ';
+        *position++ = Letter;
+
+        // "-0.000" vermeiden: Werte, die auf 0 gerundet werden, positiv ausgeben
+        constexpr double halfStep = 0.5 / pow10(Precision);
+        if (std::abs(value) < halfStep) value = 0.0;
+
+        auto result = std::to_chars(position, end, value, std::chars_format::fixed, Precision);
+        if (result.ec != std::errc()) {
+            valid = false;
+            return *this;
+        }
+        position = result.ptr;
+        return *this;
+    }
+
+    template <char Letter>
+    GCodeLineWriter &word(long long value) {
+        if (!valid || end - position < 2) {
+            valid = false;
+            return *this;
+        }
+        *position++ = ' ';
+        *position++ = Letter;
+
+        auto result = std::to_chars(position, end, value);
+        if (result.ec != std::errc()) {
+            valid = false;
+            return *this;
+        }
+        position = result.ptr;
+        return *this;
+    }
+
+    // Zeile abschließen; false, wenn sie nicht in den Puffer passte
+    bool finish() {
+        if (!valid) {
+            target.length = 0;
+            return false;
+        }
+        *position++ = '\n';
+        target.length = static_cast<std::uint8_t>(position - target.text);
+        return true;
+    }
+
+private:
+    static constexpr double pow10(int exponent) {
+        return exponent == 0 ? 1.0 : 10.0 * pow10(exponent - 1);
+    }
+
+    GCodeCommand &target;
+    char *position;
+    char *end;
+    bool valid;
+};
+
+// Vorlagen für die vom Bewegungsstapel erzeugten Befehle
+namespace GCodeEncoder {
+
+// Achsen mit 3 Nachkommastellen (1 µm), Vorschub ganzzahlig in mm/min
+constexpr int AxisPrecision = 3;
+constexpr int OffsetPrecision = 3;
+// Förderband als lineare Zusatzachse der Firmware (mm Bandweg)
+constexpr char ConveyorAxisLetter = 'A';
+
+inline bool linearMove(GCodeCommand &command, double x, double y, double z, double feedrate) {
+    return GCodeLineWriter(command).literal("G1")
+        .word<'X', AxisPrecision>(x)
+        .word<'Y', AxisPrecision>(y)
+        .word<'Z', AxisPrecision>(z)
+        .word<'F'>(std::llround(feedrate))
+        .finish();
+}
+
+// Portal und Förderband in einer gemeinsam interpolierten Bewegung
+inline bool coordinatedMove(GCodeCommand &command, double x, double y, double z,
+                            double conveyor, double feedrate) {
+    return GCodeLineWriter(command).literal("G1")
+        .word<'X', AxisPrecision>(x)
+        .word<'Y', AxisPrecision>(y)
+        .word<'Z', AxisPrecision>(z)
+        .word<ConveyorAxisLetter, AxisPrecision>(conveyor)
+        .word<'F'>(std::llround(feedrate))
+        .finish();
+}
+
+inline bool arcMove(GCodeCommand &command, bool clockwise, double x, double y, double z,
+                    double i, double j, double feedrate) {
+    GCodeLineWriter writer(command);
+    if (clockwise) writer.literal("G2");
+    else writer.literal("G3");
+    return writer.word<'X', AxisPrecision>(x)
+        .word<'Y', AxisPrecision>(y)
+        .word<'Z', AxisPrecision>(z)
+        .word<'I', OffsetPrecision>(i)
+        .word<'J', OffsetPrecision>(j)
+        .word<'F'>(std::llround(feedrate))
+        .finish();
+}
+
+inline bool dwell(GCodeCommand &command, long long milliseconds) {
+    return GCodeLineWriter(command).literal("G4").word<'P'>(milliseconds).finish();
+}
+
+inline bool fanSpeed(GCodeCommand &command, long long value) {
+    return GCodeLineWriter(command).literal("M106").word<'S'>(value).finish();
+}
+
+inline bool raw(GCodeCommand &command, std::string_view line) {
+    return GCodeLineWriter(command).append(line).finish();
+}
+
+}
+
+#endif // SOLDERROBOT_GCODE_ENCODER_H
@@ -0,0 +1,142 @@
+#ifndef SOLDERROBOT_GCODE_SENDER_H
+#define SOLDERROBOT_GCODE_SENDER_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QEvent>
+#include <QQueue>
+#include <QTimer>
+#include <QtSerialPort/QSerialPort>
+#include <atomic>
+#include "firmware_response_parser.h"
+#include "gcode_command.h"
+#include "latency_histogram.h"
+#include "lockfree_ring.h"
+
+// Zähler für Durchsatz und Füllstand des G-Code-Streams
+struct GCodeSenderStatistics {
+    quint64 linesQueued = 0;        // Insgesamt eingereihte Zeilen
+    quint64 linesSent = 0;          // An die Firmware übertragene Zeilen
+    quint64 linesAcknowledged = 0;  // Mit "ok" bestätigte Zeilen
+    quint64 bytesSent = 0;          // Übertragene Bytes
+    quint64 errors = 0;             // Mit "error" beantwortete Zeilen
+    quint64 responsesDropped = 0;   // Antworten, die nicht in den Rückkanal passten
+    int queueDepth = 0;             // Noch nicht gesendete Zeilen
+    int linesInFlight = 0;          // Gesendet, aber noch unbestätigt
+    int bytesInFlight = 0;          // Belegte Bytes im Empfangspuffer der Firmware
+    double linesPerSecond = 0.0;    // Bestätigte Zeilen pro Sekunde seit Start
+    quint64 latencyP50Us = 0;       // Zeit vom Senden bis zum "ok", Median
+    quint64 latencyP99Us = 0;
+    quint64 latencyMaxUs = 0;
+};
+
+// Wie die Firmware ihre Ist-Position meldet
+enum class PositionReportMode {
+    None,             // Keine Positionsrückmeldung
+    MarlinAutoReport, // Firmware sendet selbständig (M154 S<Sekunden>); unter
+                      // 1 s fragt der Sender stattdessen mit M114 ab
+    GrblStatusQuery   // Sender fragt periodisch mit dem Echtzeitbefehl '?' ab
+};
+
+// Nicht-blockierender G-Code-Sender mit Zeichenzählung (Grbl-Streaming).
+//
+// Das Objekt lebt auf einem eigenen I/O-Thread und besitzt dort den seriellen
+// Port. Produzenten (Jobausführung, Handbetrieb, Sicherheit) legen vorkodierte
+// Befehle über submit() in einen lock-freien MPSC-Ring; Antworten kommen über
+// einen SPSC-Ring zurück und werden mit pollResponse() abgeholt. Der Not-Aus
+// umgeht beide Ringe über ein Ereignis mit hoher Priorität.
+class GCodeSender : public QObject {
+    Q_OBJECT
+
+public:
+    explicit GCodeSender(QObject *parent = nullptr);
+    ~GCodeSender();
+
+    // Nur im I/O-Thread aufrufen (z.B. per QMetaObject::invokeMethod)
+    bool openPort(const QString &portName, qint32 baudRate);
+    void closePort();
+
+    // Thread-sicher
+    void setRxBufferSize(int bytes);
+    int rxBufferSize() const;
+    bool submit(const GCodeCommand &command);
+    void clear();
+    void requestEmergencyStop();
+    bool pollResponse(SerialResponse &response);
+    int queueDepth() const;
+    int pendingAcknowledgements() const;
+    bool isIdle() const;
+    GCodeSenderStatistics statistics() const;
+    void resetStatistics();
+    void setPositionReporting(PositionReportMode mode, int intervalMs);
+    MachinePosition machinePosition() const;
+
+signals:
+    // Wird nur ausgelöst, wenn zuvor alle Antworten abgeholt wurden
+    void responsesAvailable();
+    void queueDrained();
+    void errorOccurred(const QString &error);
+
+protected:
+    bool event(QEvent *event) override;
+
+private slots:
+    void onReadyRead();
+    void queryStatus();
+
+private:
+    struct InFlightLine {
+        quint64 lineNumber;
+        int length;
+        qint64 sentAtUs;
+        bool positionQuery;  // Vom Sender eingeschobenes M114, nicht in der Statistik
+    };
+
+    void scheduleWakeup();
+    void fillRxBuffer();
+    bool sendPositionQuery(int bufferSize);
+    void updateLinesInFlight();
+    void handleResponseLine(const FirmwareResponseParser::Line &line);
+    void releaseOldestLine(bool isError, std::string_view line);
+    void publishResponse(const SerialResponse &response);
+    void performEmergencyStop();
+
+    static const QEvent::Type WakeupEvent;
+    static const QEvent::Type EmergencyStopEvent;
+
+    QSerialPort *serialPort;
+    QTimer *statusQueryTimer;
+    MpscRing<GCodeCommand, 1024> commandRing;
+    SpscRing<SerialResponse, 1024> responseRing;
+
+    // Zustand des I/O-Threads
+    GCodeCommand heldCommand;    // Aus dem Ring entnommen, passt noch nicht in den Puffer
+    bool hasHeldCommand;
+    QQueue<InFlightLine> inFlightLines;
+    FirmwareResponseParser responseParser;
+    QElapsedTimer clock;
+    quint64 nextLineNumber;
+    PositionReportMode reportMode;
+    bool positionQueryRequested; // M114 fällig, wird vor dem Ring gesendet
+    bool positionQueryInFlight;  // M114 gesendet, "ok" steht noch aus
+
+    // Zwischen den Threads geteilt
+    std::atomic<bool> wakeupPending;
+    std::atomic<bool> responsesPending;
+    std::atomic<bool> clearRequested;
+    std::atomic<bool> emergencyStopRequested;
+    std::atomic<int> rxBufferBytes;
+    std::atomic<int> linesInFlight;
+    std::atomic<int> bytesInFlight;
+    std::atomic<quint64> linesQueued;
+    std::atomic<quint64> linesSent;
+    std::atomic<quint64> linesAcknowledged;
+    std::atomic<quint64> bytesSent;
+    std::atomic<quint64> errorCount;
+    std::atomic<quint64> responsesDropped;
+    std::atomic<qint64> statisticsStartNs;
+    LatencyHistogram ackLatencyUs;
+    AtomicMachinePosition reportedPosition;
+};
+
+#endif // SOLDERROBOT_GCODE_SENDER_H
@@ -11,6 +11,7 @@
 #include <QSlider>
 #include <QLCDNumber>
 
+class LoopStatisticsReporter;
 class MotionController;
 class SensorManager;
 class TemperatureControl;
@@ -26,6 +27,7 @@ private slots:
     void updatePosition(double x, double y, double z);
     void updateTemperature(double temp);
     void updateConveyorSpeed(int speed);
+    void updateSamplingStatus(const QString &sensor, quint64 totalOverruns);
     void emergencyStop();
 
 private:
@@ -41,11 +43,15 @@ private:
     QLCDNumber *temperatureDisplay;
     QSlider *conveyorSpeedSlider;
     QPushButton *emergencyStopButton;
+    QLabel *samplingStatusLabel;
     
     // System Components
     MotionController *motionController;
     SensorManager *sensorManager;
     TemperatureControl *temperatureControl;
+    LoopStatisticsReporter *loopReporter;
+    int preheaterChannel;
+    int feedWarmerChannel;
 };
 
 #endif // SOLDERROBOT_GUI_H
@@ -0,0 +1,94 @@
+#ifndef SOLDERROBOT_HEATER_BANK_H
+#define SOLDERROBOT_HEATER_BANK_H
+
+#include <array>
+#include <cstdint>
+#include "pid_autotuner.h"
+
+struct HeaterChannelSettings {
+    double ratedPower = 80.0;       // W bei 100 % Stellgröße
+    double maxPower = 100.0;        // Obergrenze der Stellgröße (%)
+    double maxTemperature = 450.0;  // Obergrenze des Sollwerts (°C)
+    int priority = 0;               // Bei knappem Budget zuerst versorgt (höher = wichtiger)
+    PIDGains gains;
+};
+
+// PID-Regler für mehrere Heizkreise mit gemeinsamem Leistungsbudget.
+//
+// Der Zustand liegt spaltenweise (struct of arrays) vor; update() rechnet
+// alle Kreise in einem Durchlauf und verteilt das Budget nach Priorität,
+// innerhalb einer Priorität anteilig zur Anforderung. Je Kreis gilt das
+// Regelgesetz des bisherigen Einzelreglers: begrenzter Ausgang, I-Anteil
+// ohne Windup (auch wenn das Budget kürzt), gefilterter D-Anteil auf den
+// Messwert.
+//
+// Keine Allokationen, keine Sperren; gehört dem Regelthread.
+class HeaterBank {
+public:
+    static constexpr int MaxChannels = 8;
+
+    // Liefert die Kanalnummer oder -1, wenn alle Kanäle belegt sind
+    int addChannel(const HeaterChannelSettings &settings);
+    int channelCount() const { return count; }
+    // Grenzen, Priorität und Verstärkungen eines bestehenden Kanals ersetzen
+    void configure(int channel, const HeaterChannelSettings &settings);
+
+    void setPowerBudget(double watts) { budget = watts; }
+    void setGains(int channel, const PIDGains &gains);
+    const PIDGains &gains(int channel) const { return parameters[channel]; }
+    void reset(int channel);
+    // I-Anteil vorbelegen, z.B. mit der bekannten Beharrungsleistung (%)
+    void setIntegral(int channel, double value);
+
+    // Eingänge des aktuellen Zyklus
+    void setInput(int channel, bool enabled, double setpoint, double measured, double feedForward = 0.0);
+    // Feste Stellgröße statt PID für diesen Zyklus (z.B. Relaisversuch)
+    void setOverride(int channel, double power);
+
+    void update(double dt);
+
+    double output(int channel) const { return outputs[channel]; }
+    double setpoint(int channel) const { return setpoints[channel]; }
+    // Kreis hat in diesem Zyklus weniger erhalten als angefordert
+    bool budgetLimited(int channel) const { return limited[channel]; }
+    // Summe der ausgegebenen Leistung (W)
+    double totalPower() const { return total; }
+
+private:
+    template <typename T>
+    using Column = std::array<T, MaxChannels>;
+
+    int count = 0;
+    double budget = 0.0;   // W, <= 0 = unbegrenzt
+    double total = 0.0;
+
+    // Konfiguration
+    Column<PIDGains> parameters{};
+    Column<double> ratedPower{};
+    Column<double> maxPower{};
+    Column<double> maxTemperature{};
+    Column<int> priority{};
+
+    // Eingänge
+    Column<bool> enabled{};
+    Column<bool> overridden{};
+    Column<double> overridePower{};
+    Column<double> setpoints{};
+    Column<double> measurements{};
+    Column<double> feedForwards{};
+
+    // Reglerzustand
+    Column<bool> wasEnabled{};
+    Column<bool> hasLastMeasurement{};
+    Column<double> lastMeasurement{};
+    Column<double> integral{};
+    Column<double> candidateIntegral{};
+    Column<double> filteredDerivative{};
+
+    // Ergebnis
+    Column<double> requests{};  // Angeforderte Leistung (W)
+    Column<double> outputs{};   // Zugeteilte Stellgröße (%)
+    Column<bool> limited{};
+};
+
+#endif // SOLDERROBOT_HEATER_BANK_H
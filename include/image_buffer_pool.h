@@ -0,0 +1,37 @@
+#ifndef SOLDERROBOT_IMAGE_BUFFER_POOL_H
+#define SOLDERROBOT_IMAGE_BUFFER_POOL_H
+
+#include <opencv2/opencv.hpp>
+#include <QImage>
+
+// Vorab belegte RGB-Puffer, die ohne Kopie zwischen OpenCV und Qt geteilt
+// werden. acquire() liefert einen freien Puffer zugleich als cv::Mat und als
+// QImage auf demselben Speicher. Jeder Puffer hat ein zwischengespeichertes
+// QImage, ausgegeben werden nur dessen Kopien; der Puffer ist wieder frei,
+// sobald die letzte Kopie freigegeben ist. Im eingeschwungenen Zustand wird
+// also weder Pixelspeicher noch QImageData angelegt und nichts kopiert.
+//
+// Der Pool darf vor den ausgegebenen Bildern abgebaut werden; freigeben
+// dürfen die Bilder aus jedem Thread, acquire() nur der Thread des Pools.
+class ImageBufferPool {
+public:
+    explicit ImageBufferPool(int capacity = 4);
+    ~ImageBufferPool();
+
+    ImageBufferPool(const ImageBufferPool &) = delete;
+    ImageBufferPool &operator=(const ImageBufferPool &) = delete;
+
+    // Puffer für ein RGB888-Bild der Größe 'size'. Erst über 'pixels'
+    // schreiben, dann 'image' weitergeben. false, wenn alle Puffer noch in
+    // Gebrauch sind.
+    bool acquire(cv::Size size, cv::Mat &pixels, QImage &image);
+
+    int capacity() const;
+    int available() const;
+
+private:
+    struct Core;
+    Core *core;
+};
+
+#endif // SOLDERROBOT_IMAGE_BUFFER_POOL_H
@@ -5,6 +5,7 @@
 #include <QVector>
 #include <QDateTime>
 #include <opencv2/opencv.hpp>
+#include "thermal_model.h"
 
 // Struktur für einen einzelnen Lötpunkt
 struct SolderPoint {
@@ -38,6 +39,31 @@ struct SolderJob {
     QString status;          // "waiting", "in_progress", "completed", "error"
 };
 
+// Reihenfolge der Lötpunkte
+enum class SequencingMode {
+    NearestNeighbour,       // Nur Verfahrweg
+    TransitionTime          // Nearest-Neighbor über Fahrzeit und Temperaturwechsel laut Heizmodell
+};
+
+struct SequencingSettings {
+    SequencingMode mode = SequencingMode::TransitionTime;
+    double temperatureTolerance = 5.0;  // Punkte innerhalb dieser Spanne gelten als gleich warm (K)
+    double travelSpeed = 100.0;         // Verfahrgeschwindigkeit zwischen den Punkten (mm/s)
+    double approachTime = 0.3;          // Absenken und Anheben je Punkt (s)
+    double settleTime = 1.0;            // Einschwingen nach einem Temperaturwechsel (s)
+    ThermalModel heater;                // Für die Dauer der Temperaturwechsel
+};
+
+// Vorhergesagte Taktzeit einer Platine für die gewählte Reihenfolge und
+// zum Vergleich für die reine Nearest-Neighbor-Reihenfolge
+struct SequencingReport {
+    SequencingMode mode = SequencingMode::NearestNeighbour;
+    double cycleTime = 0.0;                 // s
+    double nearestNeighbourCycleTime = 0.0; // s
+    int temperatureChanges = 0;
+    int nearestNeighbourTemperatureChanges = 0;
+};
+
 class JobManager : public QObject {
     Q_OBJECT
 
@@ -73,6 +99,15 @@ public:
     bool calibratePCB(const QString &jobId);
     QVector3D getPCBOffset(const QString &jobId) const;
 
+    // Reihenfolgeplanung beim Jobstart
+    void setSequencingSettings(const SequencingSettings &settings);
+    SequencingSettings sequencingSettings() const;
+    // Taktzeit einer Punktfolge in der gegebenen Reihenfolge, einschließlich
+    // des Wechsels auf die Temperatur des ersten Punkts der nächsten Platine
+    double predictCycleTime(const QVector<SolderPoint> &points) const;
+    // Ordnet 'points' nach den Einstellungen um; startJob() ruft das auf
+    SequencingReport optimizePointSequence(QVector<SolderPoint> &points);
+
 signals:
     void jobCreated(const QString &jobId);
     void jobUpdated(const QString &jobId);
@@ -83,18 +118,21 @@ signals:
     void progressUpdated(const QString &jobId, int current, int total);
     void pcbDetected(const QString &jobId, const PCBData &pcbData);
     void calibrationRequired(const QString &jobId);
+    void sequenceOptimized(const QString &jobId, const SequencingReport &report);
 
 private:
     QMap<QString, SolderJob> jobs;
     QString currentJobId;
     bool isJobRunning;
+    SequencingSettings sequencing;
 
     // Hilfsfunktionen
     bool validateJob(const SolderJob &job) const;
     void updateJobStatus(const QString &jobId, const QString &status);
     QVector<QPointF> detectFiducials(const cv::Mat &image);
     bool calculatePCBTransform(const PCBData &pcb, QTransform &transform);
-    void optimizePointSequence(QVector<SolderPoint> &points);
+    double transitionTime(const SolderPoint &from, const SolderPoint &to) const;
+    int countTemperatureChanges(const QVector<SolderPoint> &points) const;
 };
 
 #endif // SOLDERROBOT_JOB_MANAGER_H
@@ -0,0 +1,40 @@
+#ifndef SOLDERROBOT_LATENCY_HISTOGRAM_H
+#define SOLDERROBOT_LATENCY_HISTOGRAM_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+// Lock-freies Histogramm mit logarithmisch-linearen Klassen (HDR-Prinzip):
+// jede Zweierpotenz ist in 32 Unterklassen geteilt, der relative Fehler der
+// Perzentile liegt damit unter ca. 3 %. record() darf aus beliebigen Threads
+// aufgerufen werden und kommt ohne Sperren und Allokationen aus.
+class LatencyHistogram {
+public:
+    static constexpr int SubBucketBits = 5;
+    static constexpr int SubBucketCount = 1 << SubBucketBits;
+    static constexpr int BucketCount = (64 - SubBucketBits + 1) * SubBucketCount;
+
+    void record(std::uint64_t value);
+    void reset();
+
+    std::uint64_t count() const;
+    std::uint64_t minimum() const;
+    std::uint64_t maximum() const;
+    double mean() const;
+
+    // Wert, unter dem der Anteil 'percentile' (0..100) aller Messungen liegt
+    std::uint64_t percentile(double percentile) const;
+
+private:
+    static int bucketIndex(std::uint64_t value);
+    static std::uint64_t bucketUpperBound(int index);
+
+    std::array<std::atomic<std::uint64_t>, BucketCount> buckets{};
+    std::atomic<std::uint64_t> total{0};
+    std::atomic<std::uint64_t> sum{0};
+    std::atomic<std::uint64_t> smallest{UINT64_MAX};
+    std::atomic<std::uint64_t> largest{0};
+};
+
+#endif // SOLDERROBOT_LATENCY_HISTOGRAM_H
@@ -0,0 +1,167 @@
+#ifndef SOLDERROBOT_LOCKFREE_RING_H
+#define SOLDERROBOT_LOCKFREE_RING_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+// Größe einer Cache-Line, um False Sharing zwischen Produzent und Konsument
+// zu vermeiden
+constexpr std::size_t CacheLineSize = 64;
+
+// Ringpuffer für genau einen Produzenten und einen Konsumenten (SPSC).
+// Capacity muss eine Zweierpotenz sein.
+template <typename T, std::size_t Capacity>
+class SpscRing {
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity muss eine Zweierpotenz sein");
+
+public:
+    bool push(const T &value) {
+        std::size_t head = writeIndex.load(std::memory_order_relaxed);
+        if (head - cachedReadIndex >= Capacity) {
+            cachedReadIndex = readIndex.load(std::memory_order_acquire);
+            if (head - cachedReadIndex >= Capacity) {
+                return false; // Voll
+            }
+        }
+        buffer[head & (Capacity - 1)] = value;
+        writeIndex.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T &value) {
+        std::size_t tail = readIndex.load(std::memory_order_relaxed);
+        if (tail == cachedWriteIndex) {
+            cachedWriteIndex = writeIndex.load(std::memory_order_acquire);
+            if (tail == cachedWriteIndex) {
+                return false; // Leer
+            }
+        }
+        value = buffer[tail & (Capacity - 1)];
+        readIndex.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    std::size_t size() const {
+        return writeIndex.load(std::memory_order_acquire) - readIndex.load(std::memory_order_acquire);
+    }
+
+    bool empty() const { return size() == 0; }
+    static constexpr std::size_t capacity() { return Capacity; }
+
+private:
+    alignas(CacheLineSize) std::atomic<std::size_t> writeIndex{0};
+    std::size_t cachedReadIndex = 0;   // Nur vom Produzenten verwendet
+    alignas(CacheLineSize) std::atomic<std::size_t> readIndex{0};
+    std::size_t cachedWriteIndex = 0;  // Nur vom Konsumenten verwendet
+    alignas(CacheLineSize) std::array<T, Capacity> buffer{};
+};
+
+// Begrenzte Warteschlange für mehrere Produzenten und einen Konsumenten
+// (Verfahren nach D. Vyukov, jeder Platz trägt eine Sequenznummer).
+// Capacity muss eine Zweierpotenz sein.
+template <typename T, std::size_t Capacity>
+class MpscRing {
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity muss eine Zweierpotenz sein");
+
+public:
+    MpscRing() {
+        for (std::size_t i = 0; i < Capacity; ++i) {
+            buffer[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    bool push(const T &value) {
+        std::size_t position = writeIndex.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot &slot = buffer[position & (Capacity - 1)];
+            std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            auto difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+            if (difference == 0) {
+                if (writeIndex.compare_exchange_weak(position, position + 1,
+                                                     std::memory_order_relaxed)) {
+                    slot.value = value;
+                    slot.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (difference < 0) {
+                return false; // Voll
+            } else {
+                position = writeIndex.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool pop(T &value) {
+        std::size_t position = readIndex.load(std::memory_order_relaxed);
+        Slot &slot = buffer[position & (Capacity - 1)];
+        std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+        if (static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position + 1) < 0) {
+            return false; // Leer (oder Produzent schreibt noch)
+        }
+        value = slot.value;
+        slot.sequence.store(position + Capacity, std::memory_order_release);
+        readIndex.store(position + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    std::size_t size() const {
+        std::size_t written = writeIndex.load(std::memory_order_acquire);
+        std::size_t read = readIndex.load(std::memory_order_acquire);
+        return written > read ? written - read : 0;
+    }
+
+    bool empty() const { return size() == 0; }
+    static constexpr std::size_t capacity() { return Capacity; }
+
+private:
+    struct Slot {
+        std::atomic<std::size_t> sequence;
+        T value;
+    };
+
+    alignas(CacheLineSize) std::atomic<std::size_t> writeIndex{0};
+    alignas(CacheLineSize) std::atomic<std::size_t> readIndex{0};
+    alignas(CacheLineSize) std::array<Slot, Capacity> buffer;
+};
+
+// Dreifachpuffer für genau einen Produzenten und einen Konsumenten: der
+// Produzent schreibt immer in einen freien Platz, der Konsument liest immer
+// den zuletzt veröffentlichten. Keine Seite wartet, Zwischenstände werden
+// überschrieben. Die Plätze werden nie kopiert und können vorab belegt werden.
+template <typename T>
+class TripleBuffer {
+public:
+    // Produzent
+    T &writeSlot() { return buffer[back]; }
+    void publish() {
+        int previous = middle.exchange(back | FreshFlag, std::memory_order_acq_rel);
+        back = previous & IndexMask;
+    }
+
+    // Konsument: holt den neuesten Stand nach readSlot(); false, wenn seit dem
+    // letzten Aufruf nichts veröffentlicht wurde
+    bool acquire() {
+        if (!(middle.load(std::memory_order_acquire) & FreshFlag)) {
+            return false;
+        }
+        int previous = middle.exchange(front, std::memory_order_acq_rel);
+        front = previous & IndexMask;
+        return true;
+    }
+    const T &readSlot() const { return buffer[front]; }
+
+    // Alle Plätze, z.B. zum Vorbelegen; nur solange niemand schreibt oder liest
+    std::array<T, 3> &storage() { return buffer; }
+
+private:
+    static constexpr int IndexMask = 0x3;
+    static constexpr int FreshFlag = 0x4;
+
+    std::array<T, 3> buffer{};
+    alignas(CacheLineSize) int back = 0;           // Nur vom Produzenten verwendet
+    alignas(CacheLineSize) std::atomic<int> middle{1};
+    alignas(CacheLineSize) int front = 2;          // Nur vom Konsumenten verwendet
+};
+
+#endif // SOLDERROBOT_LOCKFREE_RING_H
@@ -0,0 +1,79 @@
+#ifndef SOLDERROBOT_LOOP_INSTRUMENTATION_H
+#define SOLDERROBOT_LOOP_INSTRUMENTATION_H
+
+#include <QObject>
+#include <QString>
+#include <QTimer>
+#include <QVector>
+#include <cstdint>
+#include "latency_histogram.h"
+
+// Perzentile einer Messgröße in Mikrosekunden
+struct PercentileSummary {
+    std::uint64_t count = 0;
+    double minimum = 0.0;
+    double p50 = 0.0;
+    double p90 = 0.0;
+    double p99 = 0.0;
+    double p999 = 0.0;
+    double maximum = 0.0;
+    double mean = 0.0;
+};
+
+struct LoopStatistics {
+    PercentileSummary period;      // Abstand zweier Zyklusbeginne
+    PercentileSummary lateness;    // Verspätung gegenüber der geplanten Weckzeit
+    PercentileSummary execution;   // Rechenzeit eines Zyklus
+    PercentileSummary latency;     // Sensor gelesen bis Stellglied/Meldung
+};
+
+// Messstelle einer periodischen Schleife. Die record*-Methoden schreiben
+// lock-frei in HDR-Histogramme (Nanosekunden) und dürfen aus dem Thread der
+// Schleife aufgerufen werden, während andere Threads auswerten.
+class LoopProbe {
+public:
+    explicit LoopProbe(const char *name);
+
+    void recordPeriod(std::int64_t ns);
+    void recordLateness(std::int64_t ns);
+    void recordExecution(std::int64_t ns);
+    void recordLatency(std::int64_t ns);
+
+    const char *name() const { return loopName; }
+    LoopStatistics statistics() const;
+    void reset();
+
+private:
+    const char *loopName;
+    LatencyHistogram periodNs;
+    LatencyHistogram latenessNs;
+    LatencyHistogram executionNs;
+    LatencyHistogram latencyNs;
+};
+
+// Gibt die Statistik der registrierten Schleifen periodisch über qDebug aus
+class LoopStatisticsReporter : public QObject {
+    Q_OBJECT
+
+public:
+    explicit LoopStatisticsReporter(QObject *parent = nullptr);
+
+    // Die Messstellen gehören den überwachten Komponenten
+    void addProbe(LoopProbe *probe);
+    // Nach jeder Ausgabe neu zählen, sonst über die gesamte Laufzeit
+    void setResetAfterDump(bool reset);
+    void start(int intervalMs);
+    void stop();
+
+    QString report() const;
+
+public slots:
+    void dump();
+
+private:
+    QTimer *dumpTimer;
+    QVector<LoopProbe *> probes;
+    bool resetAfterDump;
+};
+
+#endif // SOLDERROBOT_LOOP_INSTRUMENTATION_H
@@ -1,8 +1,36 @@
 #ifndef SOLDERROBOT_MOTION_CONTROLLER_H
 #define SOLDERROBOT_MOTION_CONTROLLER_H
 
+#include <QElapsedTimer>
 #include <QObject>
-#include <QtSerialPort/QSerialPort>
+#include <QQueue>
+#include <QThread>
+#include <QTimer>
+#include <QVector>
+#include <QVector3D>
+#include "gcode_sender.h"
+#include "path_simplifier.h"
+#include "trajectory_planner.h"
+
+struct SolderPoint;
+
+// Parameter für das Abfahren einer Lötpunktfolge
+struct SolderSequenceSettings {
+    double clearanceHeight = 5.0;   // Sicherheitsabstand über den Lötpunkten (mm)
+    double travelSpeed = 100.0;     // Verfahrgeschwindigkeit zwischen den Punkten (mm/s)
+    double approachSpeed = 10.0;    // Absenkgeschwindigkeit auf den Lötpunkt (mm/s)
+    double retractSpeed = 20.0;     // Rückzugsgeschwindigkeit (mm/s)
+};
+
+// Mitlaufendes Löten: das Förderband ist eine lineare Zusatzachse der
+// Firmware (A, in mm Bandweg) und wird mit dem Portal gemeinsam interpoliert
+struct ConveyorTrackingSettings {
+    double conveyorSpeed = 10.0;    // Bandgeschwindigkeit während des Lötens (mm/s)
+    double directionX = 1.0;        // Förderrichtung in Maschinenkoordinaten
+    double directionY = 0.0;
+    double workspaceStart = 0.0;    // Erreichbarer Bereich entlang der Förderrichtung (mm)
+    double workspaceEnd = 300.0;
+};
 
 class MotionController : public QObject {
     Q_OBJECT
@@ -12,22 +40,101 @@ public:
     ~MotionController();
 
     bool initialize();
+    void setPortName(const QString &name);
+    void setBaudRate(qint32 baudRate);
     void moveToPosition(double x, double y, double z);
+    void moveAlongPath(const QVector<QVector3D> &path);
+    // Beide Varianten liefern die geschätzte Zeit bis zum Aufsetzen auf jeden
+    // Punkt (s ab Aufruf), z.B. für TemperatureControl::planSolderPoints()
+    QVector<double> executeSolderSequence(const QVector<SolderPoint> &points,
+                                          const SolderSequenceSettings &settings = SolderSequenceSettings());
+    // Lötet eine Platine auf dem laufenden Band. Die Punkte gelten für die
+    // Bandstellung 'boardConveyorPosition'; aufeinanderfolgende Aufrufe für
+    // die nächsten Platinen werden ohne Bandhalt aneinander geplant.
+    QVector<double> executeTrackedSequence(const QVector<SolderPoint> &points, double boardConveyorPosition,
+                                const SolderSequenceSettings &settings = SolderSequenceSettings());
+    void setConveyorTracking(const ConveyorTrackingSettings &settings);
+    double conveyorPosition() const;
+    void setFeedrate(double mmPerSecond);
+    void setPlannerSettings(const PlannerSettings &settings);
+    void setPathSimplifierSettings(const PathSimplifierSettings &settings);
+    // Handbetrieb des Bandes über den PWM-Ausgang (M106, 0-100 %). Nicht
+    // zusammen mit der Bandachse A: executeTrackedSequence() schaltet den
+    // Ausgang ab, und solange mitlaufende Bewegungen ausstehen, wird der
+    // Aufruf mit errorOccurred() abgelehnt.
     void setConveyorSpeed(int speed);
+
+    // Handbetrieb: nur das jeweils neueste Ziel wird gesendet, noch nicht
+    // gesendete ältere Ziele werden verworfen
+    void jogTo(double x, double y, double z);
+    void jogConveyor(int speed);
+
+    void setPositionReporting(PositionReportMode mode, int intervalMs);
     void emergencyStop();
+    // Thread-sicher, z.B. direkt aus dem Sensorthread: sendet nur den
+    // Sofort-Stopp über den Prioritätskanal des I/O-Threads. Den Zustand
+    // räumt emergencyStop() danach im Thread des Controllers auf.
+    void requestEmergencyStop();
+
+    // Zuletzt von der Firmware gemeldete Ist-Position; thread-sicher
+    MachinePosition actualPosition() const;
+
+    // Streaming-Zustand
+    int queueDepth() const;
+    GCodeSenderStatistics senderStatistics() const;
+    void resetSenderStatistics();
 
 signals:
     void positionChanged(double x, double y, double z);
     void conveyorSpeedChanged(int speed);
     void errorOccurred(const QString &error);
 
+private slots:
+    void flushPlanner();
+    void processResponses();
+    void publishPosition();
+    void dispatchJog();
+
 private:
     bool connectToHardware();
-    void sendGCode(const QString &command);
+    void sendGCode(std::string_view line);
+    bool checkEncoded(bool encoded);
+    void appendPlannedMoves(QVector<GCodeCommand> &stream);
+    void appendArc(QVector<GCodeCommand> &stream, const PathSegment &arc);
+    void submitCommand(const GCodeCommand &command);
+    void submitStream(const QVector<GCodeCommand> &stream);
+    void sendPlannedMoves();
+    void setCommandedPosition(double x, double y, double z);
+    AxisVector axisTarget(double x, double y, double z) const;
 
-    QSerialPort *serialPort;
+    QThread *ioThread;
+    GCodeSender *gcodeSender;
+    QQueue<GCodeCommand> commandBacklog;  // Befehle, die nicht mehr in den Ring passten
+    bool isConnected;
+    QString portName;
+    qint32 baudRate;
+    TrajectoryPlanner planner;
+    PathSimplifier pathSimplifier;
+    std::vector<PlannedMove> plannedMoves;
+    QVector<GCodeCommand> commandStream;
+    QTimer *plannerFlushTimer;
+    QTimer *positionUpdateTimer;
+    PositionReportMode positionReportMode;
+    int positionReportIntervalMs;
+    quint64 lastReportSequence;
+    bool commandedPositionChanged;
+    QTimer *jogTimer;
+    QElapsedTimer motionClock;
+    AxisVector pendingJogTarget;
+    bool hasPendingJog;
+    int pendingConveyorSpeed;   // -1 = keine Änderung offen
+    qint64 motionBusyUntilNs;   // Geschätztes Ende aller gesendeten Bewegungen
+    double feedrate;
     double currentX, currentY, currentZ;
     int currentConveyorSpeed;
+    double currentConveyorPosition;   // Sollposition der Bandachse (mm)
+    bool conveyorCoordinated;         // Bandachse in den Bewegungsbefehlen mitsenden
+    ConveyorTrackingSettings tracking;
     bool isInitialized;
 };
 
@@ -0,0 +1,62 @@
+#ifndef SOLDERROBOT_PATH_SIMPLIFIER_H
+#define SOLDERROBOT_PATH_SIMPLIFIER_H
+
+#include <vector>
+#include "trajectory_planner.h"
+
+struct PathSimplifierSettings {
+    double tolerance = 0.02;      // Maximale Abweichung vom Originalpfad (mm)
+    bool mergeCollinear = true;   // Kollineare Segmente zusammenfassen
+    bool fitArcs = true;          // Punktfolgen als G2/G3-Bögen ausgeben
+    int minArcPoints = 4;         // Mindestanzahl Punkte für einen Bogen
+    int maxArcPoints = 128;       // Begrenzt den Suchaufwand pro Bogen
+    double minArcRadius = 0.5;    // mm
+    double maxArcRadius = 500.0;  // mm, darüber ist eine Gerade genauer
+};
+
+// Ausgabesegment: Gerade (G1) oder Kreisbogen in der XY-Ebene (G2/G3)
+struct PathSegment {
+    enum Type {
+        Line,
+        ArcClockwise,         // G2
+        ArcCounterClockwise   // G3
+    };
+
+    Type type;
+    AxisVector end;
+    double centerOffsetX;     // I: Mittelpunkt relativ zum Startpunkt
+    double centerOffsetY;     // J
+    int sourcePoints;         // Anzahl der ersetzten Originalpunkte
+};
+
+// Ausgabestufe zwischen Pfaderzeugung und G-Code: fasst kollineare Segmente
+// zusammen und ersetzt Punktfolgen auf Kreisbahnen innerhalb der Toleranz
+// durch Bögen. Reduziert Bytes auf der Leitung und Planer-Einträge der Firmware.
+class PathSimplifier {
+public:
+    explicit PathSimplifier(const PathSimplifierSettings &settings = PathSimplifierSettings());
+
+    void setSettings(const PathSimplifierSettings &settings);
+    const PathSimplifierSettings &settings() const;
+
+    // 'start' ist die aktuelle Position, 'points' die anzufahrenden Punkte
+    std::vector<PathSegment> simplify(const AxisVector &start,
+                                      const std::vector<AxisVector> &points) const;
+
+private:
+    struct Circle {
+        double centerX;
+        double centerY;
+        double radius;
+    };
+
+    int longestLine(const std::vector<AxisVector> &path, int first) const;
+    int longestArc(const std::vector<AxisVector> &path, int first, PathSegment &arc) const;
+    bool fitCircle(const AxisVector &a, const AxisVector &b, const AxisVector &c, Circle &circle) const;
+    bool arcMatches(const std::vector<AxisVector> &path, int first, int last,
+                    const Circle &circle, bool clockwise) const;
+
+    PathSimplifierSettings config;
+};
+
+#endif // SOLDERROBOT_PATH_SIMPLIFIER_H
@@ -0,0 +1,91 @@
+#ifndef SOLDERROBOT_PID_AUTOTUNER_H
+#define SOLDERROBOT_PID_AUTOTUNER_H
+
+// Verstärkungen eines PID-Reglers bezogen auf Sekunden, Ausgang in % Heizleistung
+struct PIDGains {
+    double kp = 2.0;                  // %/K
+    double ki = 5.0;                  // %/(K*s)
+    double kd = 0.1;                  // %*s/K
+    double derivativeFilter = 0.05;   // Zeitkonstante des D-Tiefpasses (s)
+};
+
+// Strecke erster Ordnung mit Totzeit: K * e^(-L*s) / (T*s + 1)
+struct FopdtModel {
+    double gain = 0.0;            // K in K pro % Heizleistung
+    double timeConstant = 0.0;    // T (s)
+    double deadTime = 0.0;        // L (s)
+};
+
+struct AutotuneSettings {
+    double relayAmplitude = 30.0; // Anfängliche Auslenkung um die Grundleistung (%)
+    double hysteresis = 1.0;      // Schaltschwelle um den Sollwert (K), gegen Messrauschen
+    int cycles = 5;               // Ausgewertete Schwingungen nach der ersten
+    double timeoutS = 900.0;
+};
+
+struct AutotuneResult {
+    bool success = false;
+    double ultimateGain = 0.0;    // Ku (%/K)
+    double ultimatePeriod = 0.0;  // Tu (s)
+    double bias = 0.0;            // Mittlere Heizleistung im Grenzzyklus (%)
+    FopdtModel model;
+    PIDGains gains;
+};
+
+// Relaisversuch nach Åström-Hägglund.
+//
+// Die Heizleistung springt um den Sollwert zwischen bias + d und bias - d;
+// bias wird nach jeder Schwingung so nachgeführt, dass Heiz- und Kühlphase
+// gleich lang werden. Aus Amplitude und Periode des Grenzzyklus folgen Ku und
+// Tu, aus der mittleren Leistung die statische Verstärkung. Damit wird ein
+// FOPDT-Modell bestimmt und daraus die Verstärkungen nach AMIGO berechnet,
+// die auf geringes Überschwingen ausgelegt sind.
+//
+// Reine Rechenlogik ohne Qt und Allokationen; läuft im Regelthread.
+class RelayAutotuner {
+public:
+    void start(double setpoint, double ambientTemperature, const AutotuneSettings &settings);
+    // Beendet einen laufenden Versuch als fehlgeschlagen
+    void abort();
+    // Ergebnis abgeholt: zurück in den Ruhezustand
+    void reset();
+
+    // Heizleistung (%) für den aktuellen Zyklus
+    double update(double temperature, double dt);
+
+    bool isRunning() const { return phase != Phase::Idle && phase != Phase::Done; }
+    bool isFinished() const { return phase == Phase::Done; }
+    const AutotuneResult &result() const { return tuning; }
+
+    static bool identify(double ultimateGain, double ultimatePeriod, double staticGain,
+                         FopdtModel &model);
+    static PIDGains gainsFor(const FopdtModel &model);
+
+private:
+    enum class Phase { Idle, WarmUp, Relay, Done };
+
+    void finish();
+
+    Phase phase = Phase::Idle;
+    AutotuneSettings settings;
+    AutotuneResult tuning;
+    double setpoint = 0.0;
+    double ambient = 0.0;
+    double bias = 0.0;
+    double amplitude = 0.0;
+    bool heating = true;
+    double elapsed = 0.0;
+    double lastSwitchUp = 0.0;
+    double lastSwitchDown = 0.0;
+    double highTime = 0.0;
+    double lowTime = 0.0;
+    double peakHigh = 0.0;
+    double peakLow = 0.0;
+    int completedCycles = 0;
+    // Mittelwerte über die ausgewerteten Schwingungen
+    double sumUltimateGain = 0.0;
+    double sumPeriod = 0.0;
+    double sumBias = 0.0;
+};
+
+#endif // SOLDERROBOT_PID_AUTOTUNER_H
@@ -4,6 +4,8 @@
 #include <QObject>
 #include <QVector3D>
 #include <QDateTime>
+#include "sensor_events.h"
+#include "control_clock.h"
 
 struct SecurityZone {
     QString name;
@@ -37,6 +39,9 @@ public:
     void enableSmokeDetection(bool enable);
     double getSmokeLevel() const;
     void setSmokeThreshold(double threshold);
+    // Quelle und Zeitbasis des Rauchsensors, z.B. eine Aufzeichnung;
+    // nullptr stellt Simulation bzw. monotone Systemuhr wieder her
+    void setSensorSource(SensorSource *source, ControlClock *clock = nullptr);
     
     // Kollisionserkennung
     void updateObstacleMap(const QVector<QVector3D> &obstacles);
@@ -56,6 +61,8 @@ public:
 signals:
     void securityViolation(const QString &type, const QString &description);
     void smokeDetected(double level);
+    // Jeder gelesene Rauchwert, z.B. für SensorManager::recordSample()
+    void smokeMeasured(double level, qint64 timestampNs);
     void collisionWarning(const QVector3D &position, double distance);
     void unauthorizedAccess(const QString &userId, const QString &zone);
     void emergencyStop(const QString &reason);
@@ -67,6 +74,10 @@ private:
     double currentSmokeLevel;
     double smokeThreshold;
     bool smokeDetectionEnabled;
+    MonotonicClock monotonicClock;
+    ControlClock *clock;
+    SimulatedSensorSource simulatedSource;
+    SensorSource *smokeSource;
     
     void checkZoneBoundaries(const QVector3D &position);
     void monitorEnvironment();
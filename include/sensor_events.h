@@ -0,0 +1,71 @@
+#ifndef SOLDERROBOT_SENSOR_EVENTS_H
+#define SOLDERROBOT_SENSOR_EVENTS_H
+
+#include <array>
+#include <cstdint>
+#include <random>
+
+enum class SensorId : std::uint16_t {
+    Lidar = 0,
+    Magnetic = 1,
+    Smoke = 2,
+};
+constexpr int SensorCount = 3;
+
+// Rohmesswert eines Sensors (POD für Ringpuffer)
+struct SensorSample {
+    std::int64_t timestampNs;   // Monotone Zeit der Messung
+    SensorId sensor;
+    double value;
+};
+
+// Quelle der Messwerte: die Hardware, eine Simulation oder eine Aufzeichnung.
+// Verschiedene Sensoren dürfen aus verschiedenen Threads gelesen werden,
+// derselbe Sensor nur aus einem.
+class SensorSource {
+public:
+    virtual ~SensorSource() = default;
+    // Messwert des Sensors zum Zeitpunkt nowNs; false, wenn keiner vorliegt
+    virtual bool read(SensorId sensor, std::int64_t nowNs, double &value) = 0;
+};
+
+// Zufallswerte mit festem Startwert je Sensor, damit Läufe reproduzierbar sind
+class SimulatedSensorSource : public SensorSource {
+public:
+    static constexpr std::uint32_t DefaultSeed = 5489u;
+
+    explicit SimulatedSensorSource(std::uint32_t seed = DefaultSeed);
+    bool read(SensorId sensor, std::int64_t nowNs, double &value) override;
+
+private:
+    std::array<std::mt19937, SensorCount> generators;
+};
+
+// Schaltschwellen eines Binärzustands aus einem analogen Messwert
+struct HysteresisSettings {
+    double activateThreshold = 0.0;         // Zustand wird aktiv jenseits dieser Schwelle
+    double releaseThreshold = 0.0;          // ... und erst jenseits dieser wieder inaktiv
+    bool activeBelow = false;               // true: aktiv unterhalb (z.B. Abstand)
+    std::int64_t activateDebounceNs = 0;    // So lange muss der neue Zustand anliegen
+    std::int64_t releaseDebounceNs = 0;
+};
+
+// Flankenerkennung mit Hysterese und Entprellung. update() liefert nur beim
+// Wechsel des entprellten Zustands true; dazwischen entstehen keine Meldungen.
+class EdgeDetector {
+public:
+    explicit EdgeDetector(const HysteresisSettings &settings = HysteresisSettings());
+
+    bool update(double value, std::int64_t timestampNs);
+    bool state() const { return active; }
+    void reset(bool state = false);
+    void setSettings(const HysteresisSettings &settings);
+
+private:
+    HysteresisSettings settings;
+    bool active;
+    bool pending;               // Gegenteiliger Zustand liegt an, aber noch nicht lange genug
+    std::int64_t pendingSinceNs;
+};
+
+#endif // SOLDERROBOT_SENSOR_EVENTS_H
@@ -3,7 +3,31 @@
 
 #include <QObject>
 #include <QTimer>
+#include <QVector>
+#include <atomic>
+#include "lockfree_ring.h"
+#include "loop_instrumentation.h"
+#include "sensor_events.h"
+#include "sensor_recording.h"
+#include "sensor_scheduler.h"
+#include "control_clock.h"
 
+// Sensorauswertung der Zelle.
+//
+// Die Messwerte laufen durch Flankenerkennungen mit Hysterese und
+// Entprellung; obstacleDetected() und componentDetected() werden nur bei
+// einem Zustandswechsel gesendet, unabhängig von der Abtastrate. Die
+// Rohwerte stehen über pollSamples() aus einem Ringpuffer bereit.
+//
+// Jeder Sensor tastet mit eigener Periode und Priorität auf dem Thread eines
+// SensorScheduler ab: der LiDAR im Millisekundenraster, der Magnetsensor
+// deutlich langsamer. Die Signale werden daher aus dem Sensorthread gesendet
+// und erreichen Empfänger in anderen Threads über die Ereignisschleife.
+//
+// Die Messwerte kommen aus einer SensorSource: ohne Hardware aus einer
+// Simulation mit festem Startwert, für Regressionsläufe aus einer
+// Aufzeichnung (SensorReplaySource), deren Zeitachse die eingestellte Uhr
+// vorgibt.
 class SensorManager : public QObject {
     Q_OBJECT
 
@@ -17,23 +41,77 @@ public:
     double getLidarDistance() const;
     double getMagneticFieldStrength() const;
 
+    // Quelle der Messwerte und Zeitbasis; nur vor initialize(), nullptr
+    // stellt Simulation bzw. monotone Systemuhr wieder her
+    void setSensorSource(SensorSource *source);
+    void setClock(ControlClock *clock);
+
+    // Schwellen und Entprellung; nur vor initialize() aufrufen
+    void setObstacleHysteresis(const HysteresisSettings &settings);
+    void setComponentHysteresis(const HysteresisSettings &settings);
+
+    // Weitere Sensoren (z.B. Rauch, Motorstrom) mit eigener Periode; nur vor
+    // initialize(). Die Aufgabe läuft auf dem Sensorthread.
+    int addSensorTask(const SensorTaskSettings &settings, SensorScheduler::Task task);
+
+    // Holt bis zu 'maxCount' Rohwerte in zeitlicher Reihenfolge ab. Nur ein
+    // Thread darf abholen; nicht abgeholte Werte werden bei vollem Puffer
+    // verworfen und gezählt. Gepuffert wird erst ab dem ersten Aufruf oder
+    // während einer Aufzeichnung, vorher zählt auch nichts als verworfen.
+    int pollSamples(SensorSample *samples, int maxCount);
+    quint64 droppedSamples() const;
+
+    // Schreibt alle Rohwerte in eine Binärdatei (siehe SensorRecorder). Der
+    // Recorder holt die Werte dann selbst ab, pollSamples() bleibt leer.
+    bool startRecording(const QString &path);
+    void stopRecording();
+    bool isRecording() const;
+    // Messwerte anderer Komponenten (z.B. Rauchsensor) mit aufzeichnen
+    void recordSample(SensorId sensor, double value, qint64 timestampNs);
+
+    // Messstellen je Abtastaufgabe (Periode, Verspätung, Rechenzeit, beim
+    // LiDAR zusätzlich die Latenz vom Auslesen bis zur Meldung)
+    QVector<LoopProbe *> loopProbes();
+
 signals:
     void obstacleDetected(bool detected);
     void componentDetected(bool detected);
     void sensorError(const QString &error);
+    // Eine Abtastaufgabe hat seit der letzten Meldung ihre Frist überschritten
+    void samplingOverrun(const QString &sensor, quint64 totalOverruns);
 
 private slots:
-    void updateSensorReadings();
+    void checkOverruns();
+    void drainToRecorder();
 
 private:
-    bool readLidarSensor();
-    bool readMagneticSensor();
-
-    QTimer *updateTimer;
-    double lidarDistance;
-    double magneticFieldStrength;
-    bool obstaclePresent;
-    bool componentPresent;
+    void sampleLidar(std::int64_t releaseNs);
+    void sampleMagnetic(std::int64_t releaseNs);
+    bool readLidarSensor(qint64 nowNs);
+    bool readMagneticSensor(qint64 nowNs);
+    void publishSample(SensorId sensor, double value, qint64 timestampNs);
+    int popSamples(SensorSample *samples, int maxCount);
+
+    MonotonicClock monotonicClock;
+    ControlClock *clock;
+    SimulatedSensorSource simulatedSource;
+    SensorSource *source;
+    SensorScheduler scheduler;
+    int lidarTask;
+    QTimer *overrunTimer;
+    QVector<quint64> reportedOverruns;
+    SensorRecorder recorder;
+    QTimer *recordTimer;
+    std::atomic<double> lidarDistance;
+    std::atomic<double> magneticFieldStrength;
+    EdgeDetector obstacleDetector;
+    EdgeDetector componentDetector;
+    std::atomic<bool> obstaclePresent;
+    std::atomic<bool> componentPresent;
+    SpscRing<SensorSample, 4096> sampleRing;
+    std::atomic<quint64> dropped;
+    std::atomic<bool> samplesPolled;   // pollSamples() wurde aufgerufen
+    std::atomic<bool> recording;
 };
 
 #endif // SOLDERROBOT_SENSOR_MANAGER_H
@@ -0,0 +1,79 @@
+#ifndef SOLDERROBOT_SENSOR_RECORDING_H
+#define SOLDERROBOT_SENSOR_RECORDING_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include "sensor_events.h"
+
+// Aufzeichnung von Sensorwerten in eine kompakte Binärdatei.
+//
+// Format: Kopf aus Kennung "SRSD", Version (uint16) und Reserve (uint16),
+// danach je Messwert die Zeitdifferenz zum vorherigen Messwert (ZigZag-
+// Varint, ns), die Sensornummer (uint8) und der Wert (IEEE double, little
+// endian). Bei 1 kHz sind das etwa 11 Byte je Messwert.
+//
+// Nicht threadsicher: alle Aufrufe aus einem Thread.
+class SensorRecorder {
+public:
+    SensorRecorder();
+    ~SensorRecorder();
+
+    bool open(const QString &path);
+    void append(const SensorSample &sample);
+    void close();
+
+    bool isOpen() const { return file.isOpen(); }
+    quint64 sampleCount() const { return samples; }
+
+private:
+    void flush();
+
+    QFile file;
+    QByteArray buffer;
+    std::int64_t lastTimestampNs;
+    quint64 samples;
+};
+
+// Gibt eine Aufzeichnung über die Schnittstelle der Sensoren wieder. Die
+// aufgezeichnete Zeitachse wird auf die Uhr des Lesers abgebildet: der erste
+// Messwert fällt auf den Start der Wiedergabe, read() liefert je Sensor den
+// jüngsten aufgezeichneten Wert bis zum übergebenen Zeitpunkt. Mit
+// ScaledClock läuft die Wiedergabe in Echtzeit oder beschleunigt.
+class SensorReplaySource : public SensorSource {
+public:
+    SensorReplaySource();
+
+    bool load(const QString &path);
+    // Ohne Aufruf beginnt die Wiedergabe beim ersten read()
+    void start(std::int64_t nowNs);
+
+    bool read(SensorId sensor, std::int64_t nowNs, double &value) override;
+
+    bool finished(std::int64_t nowNs) const;
+    std::int64_t durationNs() const { return lastNs - firstNs; }
+    quint64 sampleCount() const;
+    // Alle Messwerte in zeitlicher Reihenfolge, z.B. für Auswertungen ohne Uhr
+    std::vector<SensorSample> samples() const;
+
+private:
+    static constexpr std::int64_t NotStarted = std::numeric_limits<std::int64_t>::min();
+
+    struct Channel {
+        std::vector<std::int64_t> timestamps;
+        std::vector<double> values;
+        std::size_t cursor = 0;     // Nur vom Thread dieses Sensors bewegt
+    };
+
+    std::array<Channel, SensorCount> channels;
+    std::int64_t firstNs;
+    std::int64_t lastNs;
+    std::atomic<std::int64_t> startNs;
+};
+
+#endif // SOLDERROBOT_SENSOR_RECORDING_H
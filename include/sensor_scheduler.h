@@ -0,0 +1,84 @@
+#ifndef SOLDERROBOT_SENSOR_SCHEDULER_H
+#define SOLDERROBOT_SENSOR_SCHEDULER_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "loop_instrumentation.h"
+#include "control_clock.h"
+
+// Einstellungen einer periodischen Sensoraufgabe
+struct SensorTaskSettings {
+    const char *name = "";
+    std::int64_t periodNs = 0;
+    // Spätestens so lange nach der Freigabe muss die Aufgabe fertig sein;
+    // 0 bedeutet eine Periode
+    std::int64_t deadlineNs = 0;
+    // Höhere Werte laufen zuerst, wenn mehrere Aufgaben fällig sind
+    int priority = 0;
+};
+
+// Mehrratiger Abtastplaner für Sensoren.
+//
+// Jede Aufgabe hat eigene Periode, Frist und Priorität und läuft auf einem
+// gemeinsamen Thread mit absoluten Weckzeiten. Sind mehrere Aufgaben fällig,
+// läuft die mit der höchsten Priorität zuerst; nach jeder Aufgabe wird neu
+// gewählt, so dass eine schnelle sicherheitsrelevante Aufgabe höchstens eine
+// laufende langsamere abwarten muss. Fertigstellung nach der Frist zählt als
+// Überlauf; ganz verpasste Perioden werden übersprungen statt nachgeholt.
+// Die Statistik darf aus anderen Threads gelesen werden.
+class SensorScheduler {
+public:
+    // Bekommt die geplante Freigabezeit der Abtastung
+    using Task = std::function<void(std::int64_t releaseNs)>;
+
+    // Ohne Uhr wird die monotone Systemuhr verwendet
+    explicit SensorScheduler(ControlClock *clock = nullptr);
+    ~SensorScheduler();
+
+    // Nur vor start()
+    void setClock(ControlClock *clock);
+    // Nur vor start(); liefert die Nummer der Aufgabe oder -1
+    int addTask(const SensorTaskSettings &settings, Task task);
+
+    bool start();
+    void stop();
+    bool isRunning() const { return running; }
+
+    int taskCount() const { return int(tasks.size()); }
+    const SensorTaskSettings &taskSettings(int task) const;
+    // Periode, Verspätung gegenüber der Freigabe und Rechenzeit je Aufgabe
+    LoopProbe &taskProbe(int task);
+    // Fertigstellungen nach der Frist
+    std::uint64_t overruns(int task) const;
+    // Ausgelassene Perioden, weil die Aufgabe zu spät wieder an die Reihe kam
+    std::uint64_t skippedPeriods(int task) const;
+
+private:
+    struct TaskEntry {
+        TaskEntry(const SensorTaskSettings &settings, Task task);
+
+        SensorTaskSettings settings;
+        Task function;
+        std::int64_t nextReleaseNs;
+        std::int64_t lastStartNs;
+        LoopProbe probe;
+        std::atomic<std::uint64_t> overruns;
+        std::atomic<std::uint64_t> skipped;
+    };
+
+    void run();
+    TaskEntry *nextDueTask(std::int64_t nowNs);
+    void execute(TaskEntry &task);
+
+    MonotonicClock monotonicClock;
+    ControlClock *clock;
+    std::vector<std::unique_ptr<TaskEntry>> tasks;
+    std::thread worker;
+    std::atomic<bool> running;
+};
+
+#endif // SOLDERROBOT_SENSOR_SCHEDULER_H
@@ -1,20 +1,129 @@
 #ifndef SOLDERROBOT_TEMPERATURE_CONTROL_H
 #define SOLDERROBOT_TEMPERATURE_CONTROL_H
 
+#include <QMap>
 #include <QObject>
 #include <QTimer>
+#include <QVector>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include "control_clock.h"
+#include "heater_bank.h"
+#include "lockfree_ring.h"
+#include "loop_instrumentation.h"
+#include "pid_autotuner.h"
+#include "thermal_model.h"
+#include "thermal_plant.h"
 
-class PIDController {
+struct SolderPoint;
+
+// Kanal der Lötspitze; weitere Heizkreise (Vorheizung, Lotvorwärmung)
+// kommen über TemperatureControl::addHeaterChannel() dazu
+constexpr int TipChannel = 0;
+
+struct HeaterChannelState {
+    double temperature = 0.0;      // Gemessene Temperatur (°C)
+    double power = 0.0;            // Ausgegebene Stellgröße (%)
+    double setpoint = 0.0;         // Wirksamer Sollwert (°C)
+    bool budgetLimited = false;    // Vom Leistungsbudget gekürzt
+};
+
+// Vorsteuerung anhand der kommenden Lötpunkte
+struct PreBoostSettings {
+    bool enabled = true;
+    double feedForwardLeadS = 0.3;     // Vorlauf der Zusatzleistung vor dem Aufsetzen
+    double maxRampLeadS = 5.0;         // Längster Vorlauf für einen Sollwertwechsel
+    double smdLoad = 8.0;              // Wärmeentzug während des Kontakts (W)
+    double pthLoad = 20.0;
+    double defaultLoad = 12.0;
+};
+
+// Erwarteter Wärmeentzug durch einen Lötpunkt (POD für den Ring zum Regelthread)
+struct HeatDemand {
+    std::int64_t contactNs;   // Monotone Zeit des Aufsetzens
+    double durationS;         // Kontaktdauer (Verweilzeit)
+    double temperature;       // Löttemperatur des Punkts (°C)
+    double loadPower;         // Entzogene Leistung während des Kontakts (W)
+    std::uint32_t generation; // Verworfen, wenn der Plan inzwischen gelöscht wurde
+};
+
+// Zustand des Regelkreises nach einem Regelzyklus
+struct ThermalSnapshot {
+    double temperature = 0.0;      // Gemessene Temperatur (°C)
+    double power = 0.0;            // Ausgegebene Heizleistung (%)
+    double setpoint = 0.0;         // Wirksame Zieltemperatur (°C), ggf. vorgezogen
+    double feedForward = 0.0;      // Anteil der Vorsteuerung an 'power' (%)
+    double periodUs = 0.0;         // Gemessener Abstand zum vorherigen Zyklus
+    std::int64_t timestampNs = 0;  // Monotone Zeit des Zyklus
+    std::uint64_t sequence = 0;    // 0 = noch kein Zyklus gelaufen
+};
+
+// Schnappschuss für einen Schreiber (Regelthread) und beliebig viele Leser;
+// Sequenzsperre wie bei AtomicMachinePosition
+class AtomicThermalSnapshot {
 public:
-    PIDController(double kp, double ki, double kd);
-    double calculate(double setpoint, double processVariable);
+    void store(const ThermalSnapshot &snapshot) {
+        std::uint64_t sequence = version.load(std::memory_order_relaxed);
+        version.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        temperature.store(snapshot.temperature, std::memory_order_relaxed);
+        power.store(snapshot.power, std::memory_order_relaxed);
+        setpoint.store(snapshot.setpoint, std::memory_order_relaxed);
+        feedForward.store(snapshot.feedForward, std::memory_order_relaxed);
+        periodUs.store(snapshot.periodUs, std::memory_order_relaxed);
+        timestampNs.store(snapshot.timestampNs, std::memory_order_relaxed);
+        version.store(sequence + 2, std::memory_order_release);
+    }
+
+    ThermalSnapshot load() const {
+        ThermalSnapshot snapshot;
+        std::uint64_t before;
+        std::uint64_t after;
+        do {
+            before = version.load(std::memory_order_acquire);
+            snapshot.temperature = temperature.load(std::memory_order_relaxed);
+            snapshot.power = power.load(std::memory_order_relaxed);
+            snapshot.setpoint = setpoint.load(std::memory_order_relaxed);
+            snapshot.feedForward = feedForward.load(std::memory_order_relaxed);
+            snapshot.periodUs = periodUs.load(std::memory_order_relaxed);
+            snapshot.timestampNs = timestampNs.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            after = version.load(std::memory_order_relaxed);
+        } while (before != after || (before & 1));
+
+        snapshot.sequence = before / 2;
+        return snapshot;
+    }
 
 private:
-    double kp, ki, kd;
-    double lastError;
-    double integral;
+    std::atomic<std::uint64_t> version{0};
+    std::atomic<double> temperature{0.0};
+    std::atomic<double> power{0.0};
+    std::atomic<double> setpoint{0.0};
+    std::atomic<double> feedForward{0.0};
+    std::atomic<double> periodUs{0.0};
+    std::atomic<std::int64_t> timestampNs{0};
 };
 
+// Temperaturregelung der Lötspitze und weiterer Heizkreise der Zelle.
+//
+// Der Regelkreis läuft auf einem eigenen Thread mit fester Periode
+// (absolute Weckzeiten über clock_nanosleep), unabhängig von der Last der
+// GUI-Ereignisschleife. Sollwert und Freigabe werden über Atomics übergeben,
+// Messwert und Leistung über einen Schnappschuss zurückgemeldet.
+//
+// Sind die kommenden Lötpunkte bekannt (planSolderPoints), wird der Sollwert
+// vor einem Temperaturwechsel vorgezogen und der erwartete Wärmeentzug kurz
+// vor dem Aufsetzen als Vorsteuerung aufgeschaltet, statt erst auf den
+// Temperatureinbruch zu reagieren.
+//
+// Alle Heizkreise werden im selben Zyklus von einer HeaterBank gerechnet
+// und teilen sich ein Leistungsbudget. Zusätzliche Kreise kosten weder
+// Timer noch Signale; ihr Zustand wird bei Bedarf über channelState()
+// abgefragt. temperatureChanged() meldet nur die Lötspitze.
 class TemperatureControl : public QObject {
     Q_OBJECT
 
@@ -23,26 +132,149 @@ public:
     ~TemperatureControl();
 
     bool initialize();
+    // Lötspitze
     void setTargetTemperature(double temperature);
     double getCurrentTemperature() const;
+    // Hauptschalter aller Heizkreise (Not-Aus)
     void enableHeating(bool enable);
 
+    // Nur vor initialize() aufrufen
+    void setThermalModel(const ThermalModel &model);
+    void setPreBoostSettings(const PreBoostSettings &settings);
+    // Uhr und Heizung austauschen, z.B. gegen SimulatedClock und
+    // SimulatedThermalPlant; nullptr stellt Systemuhr bzw. eingebaute
+    // Simulation wieder her. Die Objekte gehören dem Aufrufer.
+    void setClock(ControlClock *clock);
+    void setHeaterInterface(HeaterInterface *heater);
+    // Weiterer Heizkreis; ohne 'heater' wird er simuliert. Liefert die
+    // Kanalnummer oder -1, wenn keine Kanäle mehr frei sind.
+    int addHeaterChannel(const HeaterChannelSettings &settings, HeaterInterface *heater = nullptr);
+    int channelCount() const;
+    HeaterChannelSettings heaterChannelSettings(int channel) const;
+    // Weitere Heizkreise der Zelle und Leistungsbudget aus der
+    // Temperaturkonfiguration (config/temperature.json); nur vor initialize()
+    bool loadHeaterConfiguration(const QString &filename);
+    // Kanalnummer eines dort benannten Heizkreises, -1 = nicht konfiguriert
+    int heaterChannel(const QString &name) const;
+
+    // Ohne Regelthread: führt die Regelzyklen für 'seconds' im aufrufenden
+    // Thread aus. Mit einer SimulatedClock schneller als Echtzeit.
+    void runSimulation(double seconds);
+
+    // Kommende Lötpunkte mit Zeit bis zum Aufsetzen (s ab jetzt, < 0 = entfällt),
+    // wie von MotionController::executeSolderSequence() geliefert
+    void planSolderPoints(const QVector<SolderPoint> &points, const QVector<double> &contactTimes);
+    void clearPlannedPoints();
+
+    // Verstärkungen je Spitzentyp, gespeichert in heater_tuning.json;
+    // ohne gespeicherte Werte gelten die Standardverstärkungen
+    void setTipType(const QString &type);
+    QString tipType() const;
+    void setPIDGains(const PIDGains &gains);
+    PIDGains pidGains() const;
+
+    // Relaisversuch um die aktuelle Zieltemperatur. Die Heizung muss
+    // freigegeben sein; Abschalten der Heizung bricht den Versuch ab.
+    // Das Ergebnis wird für den aktuellen Spitzentyp gespeichert.
+    bool startAutotune(const AutotuneSettings &settings = AutotuneSettings());
+    void cancelAutotune();
+    bool isAutotuning() const;
+    AutotuneResult lastAutotuneResult() const;
+
+    // Thread-sicher
+    void setChannelTarget(int channel, double temperature);
+    void enableChannel(int channel, bool enable);
+    HeaterChannelState channelState(int channel) const;
+    // Gemeinsames Budget aller Heizkreise (W), <= 0 = unbegrenzt
+    void setPowerBudget(double watts);
+    double totalPower() const;
+    void setControlRate(int hertz);
+    int controlRate() const;
+    ThermalSnapshot snapshot() const;
+    quint64 overrunCount() const;
+    // Periode, Verspätung, Rechenzeit und Sensor-bis-Stellglied-Latenz des Regelzyklus
+    LoopProbe &controlLoopProbe();
+
 signals:
     void temperatureChanged(double temperature);
     void temperatureError(const QString &error);
+    void autotuneFinished(bool success);
 
 private slots:
-    void updateTemperature();
+    void publishTemperature();
+    void feedDemands();
 
 private:
-    void applyHeatingPower(double power);
-    double readTemperatureSensor();
-
-    QTimer *updateTimer;
-    PIDController *pidController;
-    double targetTemperature;
-    double currentTemperature;
-    bool heatingEnabled;
+    void controlLoop();
+    void runCycle(std::int64_t &deadlineNs, std::int64_t &lastCycleNs);
+    void updateTemperature(double dt, std::int64_t timestampNs);
+    void updatePreview(std::int64_t nowNs, double measuredTemp, double &setpoint,
+                       double &feedForward);
+    bool updateAutotune(bool heating, double setpoint, double measuredTemp, double dt, double &power);
+    bool loadTuning(const QString &type, PIDGains &gains) const;
+    bool saveTuning(const QString &type, const AutotuneResult &result) const;
+    double heatLoadFor(const SolderPoint &point) const;
+    void applyHeatingPower(int channel, double power, std::int64_t timestampNs);
+    double readTemperatureSensor(int channel, std::int64_t timestampNs);
+
+    QTimer *publishTimer;
+    std::thread controlThread;
+    std::atomic<bool> running;
+
+    // Von der GUI gesetzt, vom Regelthread gelesen
+    std::array<std::atomic<double>, HeaterBank::MaxChannels> channelTargets;
+    std::array<std::atomic<bool>, HeaterBank::MaxChannels> channelEnabled;
+    std::atomic<bool> heatingEnabled;
+    // Schreibzugriffe auf die Stellglieder; enableHeating(false) schaltet
+    // darüber sofort ab, ohne auf den nächsten Regelzyklus zu warten
+    std::mutex heaterWriteMutex;
+    std::atomic<double> powerBudget;
+    std::atomic<int> controlRateHz;
+    std::atomic<std::uint32_t> demandGeneration;
+    SpscRing<HeatDemand, 256> demandRing;
+    SpscRing<PIDGains, 4> gainsRing;
+    SpscRing<AutotuneSettings, 2> autotuneRequests;
+    std::atomic<bool> autotuneCancel;
+    ThermalModel model;
+    PreBoostSettings preBoost;
+    MonotonicClock systemClock;
+    ControlClock *clock;
+    // Kanalkonfiguration, nur vor initialize() geändert
+    int channels;
+    std::array<HeaterChannelSettings, HeaterBank::MaxChannels> channelSettings;
+    std::array<SimulatedThermalPlant, HeaterBank::MaxChannels> simulatedPlants;
+    std::array<HeaterInterface *, HeaterBank::MaxChannels> heaters;
+
+    // Vom Regelthread geschrieben
+    AtomicThermalSnapshot state;
+    std::array<std::atomic<double>, HeaterBank::MaxChannels> channelTemperatures;
+    std::array<std::atomic<double>, HeaterBank::MaxChannels> channelPowers;
+    std::array<std::atomic<double>, HeaterBank::MaxChannels> channelSetpoints;
+    std::array<std::atomic<bool>, HeaterBank::MaxChannels> channelLimited;
+    std::atomic<double> totalHeaterPower;
+    std::atomic<quint64> overruns;
+    LoopProbe loopProbe;
+    SpscRing<AutotuneResult, 2> autotuneResults;
+    quint64 lastPublishedSequence;
+
+    // Nur im GUI-Thread: Lötplan, der noch nicht in den Ring passte
+    QVector<HeatDemand> plannedDemands;
+    int nextPlannedDemand;
+    QString tuningPath;
+    QMap<QString, int> namedChannels;
+    QString currentTipType;
+    QString autotuneTipType;
+    PIDGains currentGains;
+    AutotuneResult lastAutotune;
+    bool autotuneActive;
+
+    // Nur im Regelthread
+    HeaterBank bank;
+    RelayAutotuner autotuner;
+    HeatDemand nextDemand;
+    bool hasNextDemand;
+    double previewSetpoint;   // Vom Lötplan vorgegebener Sollwert, <= 0 = keiner
+    double activeLoad;        // Wärmeentzug im Simulationsmodell (W)
 };
 
 #endif // SOLDERROBOT_TEMPERATURE_CONTROL_H
@@ -0,0 +1,17 @@
+#ifndef SOLDERROBOT_THERMAL_MODEL_H
+#define SOLDERROBOT_THERMAL_MODEL_H
+
+// Vereinfachtes Wärmemodell der Lötspitze als Einzelmasse:
+// C * dT/dt = P_heiz - k * (T - T_umgebung) - P_last
+struct ThermalModel {
+    double heaterPower = 80.0;         // W bei 100 % Heizleistung
+    double heatCapacity = 4.0;         // J/K, Spitze und Heizelement
+    double lossCoefficient = 0.15;     // W/K an die Umgebung
+    double ambientTemperature = 25.0;  // °C
+
+    // Dauer eines Temperaturwechsels von 'from' nach 'to' mit voller
+    // Heizleistung bzw. ausgeschalteter Heizung (s)
+    double rampTime(double from, double to) const;
+};
+
+#endif // SOLDERROBOT_THERMAL_MODEL_H
@@ -0,0 +1,78 @@
+#ifndef SOLDERROBOT_THERMAL_PLANT_H
+#define SOLDERROBOT_THERMAL_PLANT_H
+
+#include <cstdint>
+
+// Sensor und Stellglied der Heizung
+class HeaterInterface {
+public:
+    virtual ~HeaterInterface() = default;
+    // Gemessene Temperatur (°C) zum Zeitpunkt nowNs
+    virtual double readTemperature(std::int64_t nowNs) = 0;
+    // Heizleistung (%) ab nowNs
+    virtual void applyPower(double percent, std::int64_t nowNs) = 0;
+};
+
+struct PlantParameters {
+    double heaterPower = 80.0;          // W bei 100 % Heizleistung
+    double heaterCapacity = 1.5;        // J/K, Heizpatrone
+    double tipCapacity = 2.5;           // J/K, Lötspitze
+    double heaterToTip = 2.0;           // W/K, Wärmeleitwert Patrone -> Spitze
+    double ambientLoss = 0.15;          // W/K, Spitze -> Umgebung
+    double ambientTemperature = 25.0;   // °C
+    double sensorTimeConstant = 0.3;    // s, Thermoelement in der Spitze
+    double stepS = 0.001;               // Integrationsschritt (s)
+};
+
+// Wärmesenke eines Lötpunkts: Pad mit Kupferfläche, die über das Lot
+// an der Spitze hängt und ihrerseits Wärme in die Platine abgibt
+struct PadLoad {
+    double contactConductance = 0.03;   // W/K, Spitze -> Pad
+    double capacity = 0.2;              // J/K, Pad und angebundenes Kupfer
+    double boardConductance = 0.01;     // W/K, Pad -> Platine
+    double initialTemperature = 25.0;   // °C
+};
+
+// Zwei-Massen-Modell der Lötspitze (Patrone und Spitze) mit Sensorverzögerung,
+// Umgebungsverlusten und optionalem Pad im Kontakt. Die Zustände werden bei
+// jedem Zugriff bis zum übergebenen Zeitpunkt integriert, die Simulation
+// läuft also genau so schnell wie die Uhr, die sie antreibt.
+class SimulatedThermalPlant : public HeaterInterface {
+public:
+    explicit SimulatedThermalPlant(const PlantParameters &parameters = PlantParameters());
+
+    double readTemperature(std::int64_t nowNs) override;
+    void applyPower(double percent, std::int64_t nowNs) override;
+
+    void setParameters(const PlantParameters &parameters);
+    const PlantParameters &parameters() const { return plant; }
+    void reset(double temperature);
+
+    // Pad ab nowNs an der Spitze bzw. wieder abgehoben
+    void beginContact(const PadLoad &pad, std::int64_t nowNs);
+    void endContact(std::int64_t nowNs);
+    bool inContact() const { return contact; }
+    // Zusätzlicher konstanter Wärmeentzug (W), z.B. aus einem Lötplan geschätzt
+    void setLoadPower(double watts) { loadPower = watts; }
+
+    double tipTemperature() const { return tip; }
+    double heaterTemperature() const { return heater; }
+    double padTemperature() const { return padTemp; }
+
+private:
+    void advanceTo(std::int64_t nowNs);
+
+    PlantParameters plant;
+    PadLoad pad;
+    bool contact;
+    double power;       // %
+    double loadPower;   // W
+    double heater;
+    double tip;
+    double padTemp;
+    double sensor;
+    std::int64_t lastNs;
+    bool started;
+};
+
+#endif // SOLDERROBOT_THERMAL_PLANT_H
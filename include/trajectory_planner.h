@@ -0,0 +1,81 @@
+#ifndef SOLDERROBOT_TRAJECTORY_PLANNER_H
+#define SOLDERROBOT_TRAJECTORY_PLANNER_H
+
+#include <array>
+#include <deque>
+#include <vector>
+
+// Geplante Achsen: X, Y, Z und das Förderband als lineare Zusatzachse (mm Bandweg)
+constexpr int PlannerAxes = 4;
+constexpr int ConveyorAxis = 3;
+using AxisVector = std::array<double, PlannerAxes>;
+
+struct PlannerSettings {
+    double maxSpeed = 100.0;          // mm/s
+    double acceleration = 1000.0;     // mm/s²
+    double junctionDeviation = 0.05;  // mm, zulässige Abweichung an Ecken
+    int lookAhead = 16;               // Anzahl gepufferter Bewegungen
+    double conveyorMaxSpeed = 50.0;   // mm/s, Grenze der Förderbandachse
+    double conveyorAcceleration = 200.0; // mm/s²
+};
+
+// Fertig geplantes Segment mit Geschwindigkeitsprofil (Trapez)
+struct PlannedMove {
+    AxisVector target;
+    double length;        // mm
+    double entrySpeed;    // mm/s
+    double cruiseSpeed;   // mm/s, im Segment erreichte Spitzengeschwindigkeit
+    double exitSpeed;     // mm/s
+    double duration;      // s
+
+    double feedrate() const { return cruiseSpeed * 60.0; } // mm/min für G-Code
+};
+
+// Vorausschauender Bahnplaner: puffert die nächsten Bewegungen, berechnet
+// Übergangsgeschwindigkeiten an den Ecken (Junction Deviation) und gibt
+// Segmente erst frei, wenn ihre Austrittsgeschwindigkeit feststeht.
+class TrajectoryPlanner {
+public:
+    explicit TrajectoryPlanner(const PlannerSettings &settings = PlannerSettings());
+
+    void setSettings(const PlannerSettings &settings);
+    const PlannerSettings &settings() const;
+
+    // Planer leeren und Startposition setzen (Maschine steht)
+    void reset(const AxisVector &position);
+
+    // Bewegung anhängen; freigegebene Segmente werden an 'output' angehängt
+    void addMove(const AxisVector &target, double nominalSpeed,
+                 std::vector<PlannedMove> &output);
+
+    // Alle gepufferten Segmente mit Stillstand am Ende freigeben
+    void flush(std::vector<PlannedMove> &output);
+
+    int bufferedMoves() const;
+
+private:
+    struct Block {
+        AxisVector target;
+        AxisVector unit;
+        double length;
+        double nominalSpeed;
+        double acceleration;  // Durch die Förderbandachse ggf. reduziert
+        double maxEntrySpeed;
+        double entrySpeed;
+    };
+
+    void recalculate();
+    void releaseFront(double exitSpeed, std::vector<PlannedMove> &output);
+    double junctionSpeed(const AxisVector &previousUnit, const AxisVector &unit,
+                         double acceleration) const;
+
+    PlannerSettings config;
+    std::deque<Block> blocks;
+    AxisVector lastPosition;
+    AxisVector lastUnit;
+    double lastNominalSpeed;
+    double lastAcceleration;
+    double releasedExitSpeed;  // Austrittsgeschwindigkeit des zuletzt freigegebenen Segments
+};
+
+#endif // SOLDERROBOT_TRAJECTORY_PLANNER_H
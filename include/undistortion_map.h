@@ -0,0 +1,41 @@
+#ifndef SOLDERROBOT_UNDISTORTION_MAP_H
+#define SOLDERROBOT_UNDISTORTION_MAP_H
+
+#include <opencv2/opencv.hpp>
+#include <QString>
+
+// Vorberechnete Entzerrung für eine Kalibrierung und Auflösung.
+//
+// initUndistortRectifyMap() läuft einmal, die Tabellen liegen als
+// Festkomma (CV_16SC2 + CV_16UC1) vor und werden neben der
+// Kalibrierdatei gespeichert. remapRegion() entzerrt nur einen Ausschnitt:
+// die Tabellen enthalten absolute Quellkoordinaten, ein Ausschnitt der
+// Tabellen liefert also genau den Ausschnitt des entzerrten Bildes.
+class UndistortionMap {
+public:
+    bool build(const cv::Mat &cameraMatrix, const cv::Mat &distCoeffs, cv::Size size);
+    // false, wenn die Datei fehlt oder zu anderer Kalibrierung/Auflösung gehört
+    bool load(const QString &path, const cv::Mat &cameraMatrix, const cv::Mat &distCoeffs, cv::Size size);
+    bool save(const QString &path) const;
+    void clear();
+
+    bool isValid() const { return !map1.empty(); }
+    cv::Size size() const { return map1.size(); }
+    bool matches(const cv::Mat &cameraMatrix, const cv::Mat &distCoeffs, cv::Size size) const;
+
+    // 'output' wird nur bei geänderter Größe neu belegt
+    void remap(const cv::Mat &input, cv::Mat &output) const;
+    void remapRegion(const cv::Mat &input, const cv::Rect &region, cv::Mat &output) const;
+
+    // Ablageort der Tabellen zu einer Kalibrierdatei
+    static QString pathFor(const QString &calibrationFile);
+
+private:
+    static std::vector<double> fingerprint(const cv::Mat &cameraMatrix, const cv::Mat &distCoeffs);
+
+    cv::Mat map1;                   // CV_16SC2: ganzzahlige Quellkoordinaten
+    cv::Mat map2;                   // CV_16UC1: Index der Interpolationsgewichte
+    std::vector<double> parameters; // Kalibrierung, aus der die Tabellen stammen
+};
+
+#endif // SOLDERROBOT_UNDISTORTION_MAP_H
@@ -4,6 +4,12 @@
 #include <QObject>
 #include <opencv2/opencv.hpp>
 #include <QImage>
+#include <QTimer>
+#include <QTransform>
+#include "camera_capture.h"
+#include "image_buffer_pool.h"
+#include "job_manager.h"
+#include "undistortion_map.h"
 
 struct SolderJointAnalysis {
     bool isAcceptable;
@@ -18,7 +24,11 @@ class VisionSystem : public QObject {
     Q_OBJECT
 
 public:
+    // Kantenlänge des Ausschnitts um eine Lötstelle (Pixel)
+    static constexpr int DefaultJointRoiSize = 64;
+
     explicit VisionSystem(QObject *parent = nullptr);
+    ~VisionSystem();
     
     // Kamera-Steuerung
     bool initialize();
@@ -27,16 +37,36 @@ public:
     void setExposure(double value);
     void setGain(double value);
     
-    // Bildverarbeitung
+    // Bildverarbeitung. Die Bilder kommen ohne Warten aus dem Aufnahmethread;
+    // alle Aufrufe aus dem Thread des VisionSystem sehen dasselbe neueste Bild.
+    const CameraFrame &latestFrame();
+    // RGB-Bild in einem Puffer des Pools, ohne Kopie mit OpenCV geteilt.
+    // Mehrfache Aufrufe für dasselbe Kamerabild liefern dasselbe QImage.
     QImage getCurrentFrame();
     cv::Mat getProcessedFrame();
     SolderJointAnalysis analyzeSolderJoint(const cv::Mat &image);
+    // Alle Lötstellen einer Platine aus einem Bild: je Punkt ein Ausschnitt um
+    // die mit 'boardToImage' ins Bild abgebildete Position, die Ausschnitte
+    // werden parallel ausgewertet. Ergebnis in der Reihenfolge von 'points';
+    // Punkte außerhalb des Bildes gelten als "not_visible". Mit geladener
+    // Kalibrierung werden nur die Ausschnitte entzerrt; 'boardToImage' bildet
+    // dann auf entzerrte Pixel ab.
+    QVector<SolderJointAnalysis> analyzeSolderJoints(const cv::Mat &frame,
+                                                     const QVector<SolderPoint> &points,
+                                                     const QTransform &boardToImage,
+                                                     int roiSize = DefaultJointRoiSize);
+    // Dasselbe mit dem neuesten Kamerabild
+    QVector<SolderJointAnalysis> analyzeSolderJoints(const QVector<SolderPoint> &points,
+                                                     const QTransform &boardToImage,
+                                                     int roiSize = DefaultJointRoiSize);
     QVector<cv::Point2f> detectSolderPoints(const cv::Mat &image);
     
     // Kalibrierung
     bool calibrateCamera();
     bool loadCalibration(const QString &filename);
     bool saveCalibration(const QString &filename);
+    // Entzerrungstabellen zur aktuellen Kalibrierung und Auflösung
+    const UndistortionMap &undistortionMap() const { return undistortion; }
     
 signals:
     void frameReady(const QImage &frame);
@@ -45,13 +75,27 @@ signals:
     void errorOccurred(const QString &error);
 
 private:
-    cv::VideoCapture camera;
+    void publishFrame();
+    const CameraFrame *waitForNextFrame(std::uint64_t afterSequence, int timeoutMs);
+    bool updateUndistortion();
+
+    CameraCapture camera;
+    QTimer *frameTimer;
+    std::uint64_t publishedSequence;
+    ImageBufferPool imagePool;
+    QImage currentImage;
+    std::uint64_t currentImageSequence;
     cv::Mat cameraMatrix;
     cv::Mat distCoeffs;
+    QString calibrationFile;
+    UndistortionMap undistortion;
+    cv::Mat rectifiedFrame;
     bool isInitialized;
     
     // Bildverarbeitungsfunktionen
     cv::Mat preprocessImage(const cv::Mat &input);
+    // Schreibt in 'output', das nur bei geänderter Größe neu belegt wird
+    void preprocessImage(const cv::Mat &input, cv::Mat &output);
     cv::Mat segmentSolderJoint(const cv::Mat &input);
     QVector<cv::Point2f> findFeaturePoints(const cv::Mat &input);
     double calculateSurfaceQuality(const cv::Mat &joint);
@@ -0,0 +1,124 @@
+#include "camera_capture.h"
+
+namespace {
+// Nach einem Lesefehler kurz warten, statt die CPU mit Wiederholungen zu belegen
+constexpr std::int64_t ReadRetryDelayNs = 5000000;
+}
+
+CameraCapture::CameraCapture()
+    : running(false)
+    , sequence(0)
+    , failures(0)
+    , propertiesPending(false)
+{
+}
+
+CameraCapture::~CameraCapture() {
+    close();
+}
+
+bool CameraCapture::open(const CameraSettings &settings) {
+    close();
+    if (!camera.open(settings.device)) {
+        return false;
+    }
+
+    camera.set(cv::CAP_PROP_FRAME_WIDTH, settings.width);
+    camera.set(cv::CAP_PROP_FRAME_HEIGHT, settings.height);
+    camera.set(cv::CAP_PROP_FPS, settings.fps);
+
+    // Die Kamera liefert nicht zwingend die gewünschte Auflösung
+    size = cv::Size(int(camera.get(cv::CAP_PROP_FRAME_WIDTH)),
+                    int(camera.get(cv::CAP_PROP_FRAME_HEIGHT)));
+    if (size.area() <= 0) {
+        size = cv::Size(settings.width, settings.height);
+    }
+
+    // retrieve() schreibt dann in den vorhandenen Speicher
+    for (CameraFrame &frame : frames.storage()) {
+        frame.image.create(size, CV_8UC3);
+        frame.captureNs = 0;
+        frame.sequence = 0;
+    }
+    return true;
+}
+
+void CameraCapture::close() {
+    stop();
+    if (camera.isOpened()) {
+        camera.release();
+    }
+}
+
+bool CameraCapture::isOpened() const {
+    return camera.isOpened();
+}
+
+bool CameraCapture::start() {
+    if (running || !camera.isOpened()) {
+        return running;
+    }
+    running = true;
+    worker = std::thread(&CameraCapture::run, this);
+    return true;
+}
+
+void CameraCapture::stop() {
+    running = false;
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+void CameraCapture::setProperty(int property, double value) {
+    if (!running) {
+        camera.set(property, value);
+        return;
+    }
+    std::lock_guard<std::mutex> lock(propertyMutex);
+    pendingProperties.emplace_back(property, value);
+    propertiesPending = true;
+}
+
+const CameraFrame &CameraCapture::latestFrame() {
+    frames.acquire();
+    return frames.readSlot();
+}
+
+void CameraCapture::applyPendingProperties() {
+    std::vector<std::pair<int, double>> properties;
+    {
+        std::lock_guard<std::mutex> lock(propertyMutex);
+        properties.swap(pendingProperties);
+        propertiesPending = false;
+    }
+    for (const auto &property : properties) {
+        camera.set(property.first, property.second);
+    }
+}
+
+void CameraCapture::run() {
+    while (running) {
+        if (propertiesPending.load(std::memory_order_relaxed)) {
+            applyPendingProperties();
+        }
+
+        // grab() wartet auf das nächste Bild der Kamera; der Zeitpunkt danach
+        // liegt am nächsten an der Belichtung
+        if (!camera.grab()) {
+            failures.fetch_add(1, std::memory_order_relaxed);
+            clock.sleepUntil(clock.nowNs() + ReadRetryDelayNs);
+            continue;
+        }
+        std::int64_t captureNs = clock.nowNs();
+
+        CameraFrame &frame = frames.writeSlot();
+        if (!camera.retrieve(frame.image) || frame.image.empty()) {
+            failures.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+        frame.captureNs = captureNs;
+        frame.sequence = sequence.fetch_add(1, std::memory_order_relaxed) + 1;
+        frames.publish();
+    }
+}
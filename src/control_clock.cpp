@@ -0,0 +1,57 @@
+#include "control_clock.h"
+#include <QtGlobal>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+// clock_nanosleep fehlt unter macOS; dort wie unter Windows über std::chrono
+#if defined(Q_OS_UNIX) && !defined(Q_OS_DARWIN)
+#define SOLDERROBOT_POSIX_CLOCK
+#include <cerrno>
+#include <time.h>
+#endif
+
+namespace {
+constexpr std::int64_t NanosecondsPerSecond = 1000000000;
+}
+
+std::int64_t MonotonicClock::nowNs() const {
+#ifdef SOLDERROBOT_POSIX_CLOCK
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return std::int64_t(now.tv_sec) * NanosecondsPerSecond + now.tv_nsec;
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+void MonotonicClock::sleepUntil(std::int64_t deadlineNs) {
+#ifdef SOLDERROBOT_POSIX_CLOCK
+    timespec deadline;
+    deadline.tv_sec = time_t(deadlineNs / NanosecondsPerSecond);
+    deadline.tv_nsec = long(deadlineNs % NanosecondsPerSecond);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, nullptr) == EINTR) {}
+#else
+    std::this_thread::sleep_until(std::chrono::steady_clock::time_point(
+        std::chrono::nanoseconds(deadlineNs)));
+#endif
+}
+
+ScaledClock::ScaledClock(double speed)
+    : originNs(monotonic.nowNs())
+    , factor(speed > 0.0 ? speed : 1.0)
+{
+}
+
+std::int64_t ScaledClock::nowNs() const {
+    return originNs + std::int64_t(double(monotonic.nowNs() - originNs) * factor);
+}
+
+void ScaledClock::sleepUntil(std::int64_t deadlineNs) {
+    monotonic.sleepUntil(originNs + std::int64_t(double(deadlineNs - originNs) / factor));
+}
+
+void SimulatedClock::sleepUntil(std::int64_t deadlineNs) {
+    current = std::max(current, deadlineNs);
+}
@@ -0,0 +1,106 @@
+#include "firmware_response_parser.h"
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+
+namespace {
+// Zahl nach 'prefix' (z.B. "X:") lesen; Suche beginnt bei 'position'
+bool parseValueAfter(std::string_view text, std::string_view prefix, double &value,
+                     std::size_t &position) {
+    std::size_t found = text.find(prefix, position);
+    if (found == std::string_view::npos) return false;
+
+    const char *begin = text.data() + found + prefix.size();
+    const char *end = text.data() + text.size();
+    if (begin < end && *begin == '+') ++begin;
+    auto result = std::from_chars(begin, end, value);
+    if (result.ec != std::errc()) return false;
+
+    position = std::size_t(result.ptr - text.data());
+    return true;
+}
+
+// Drei durch Komma getrennte Werte nach 'prefix' lesen (Grbl "MPos:x,y,z")
+bool parseTripleAfter(std::string_view text, std::string_view prefix, double values[3]) {
+    std::size_t position = 0;
+    if (!parseValueAfter(text, prefix, values[0], position)) return false;
+
+    const char *end = text.data() + text.size();
+    const char *next = text.data() + position;
+    for (int i = 1; i < 3; ++i) {
+        if (next >= end || *next != ',') return false;
+        auto result = std::from_chars(next + 1, end, values[i]);
+        if (result.ec != std::errc()) return false;
+        next = result.ptr;
+    }
+    return true;
+}
+}
+
+FirmwareResponseParser::Line FirmwareResponseParser::classify(std::string_view text) {
+    Line line{LineType::Other, text, 0.0, 0.0, 0.0};
+
+    if (text == "ok" || text.substr(0, 3) == "ok ") {
+        line.type = LineType::Ok;
+    } else if (text.substr(0, 5) == "error" || text.substr(0, 5) == "Error") {
+        line.type = LineType::Error;
+    } else if (parseMarlinPosition(text, line.x, line.y, line.z) ||
+               parseGrblStatus(text, line.x, line.y, line.z)) {
+        line.type = LineType::Position;
+    }
+    return line;
+}
+
+void FirmwareResponseParser::appendPartial(const char *data, std::size_t size) {
+    // Überlange Zeilen werden abgeschnitten; sie sind nie Positions- oder ok-Zeilen
+    std::size_t copied = std::min(size, MaxLineLength - partialLength);
+    std::memcpy(partial + partialLength, data, copied);
+    partialLength += copied;
+}
+
+std::string_view FirmwareResponseParser::trim(std::string_view text) {
+    while (!text.empty() && (text.front() == ' ' || text.front() == '\r' || text.front() == '\t')) {
+        text.remove_prefix(1);
+    }
+    while (!text.empty() && (text.back() == ' ' || text.back() == '\r' || text.back() == '\t')) {
+        text.remove_suffix(1);
+    }
+    return text;
+}
+
+bool FirmwareResponseParser::parseMarlinPosition(std::string_view text, double &x, double &y, double &z) {
+    // "X:10.00 Y:20.00 Z:0.00 E:0.00 Count X:..." (M114 und M154-Autoreport)
+    if (text.substr(0, 2) != "X:") return false;
+
+    std::size_t position = 0;
+    return parseValueAfter(text, "X:", x, position)
+        && parseValueAfter(text, "Y:", y, position)
+        && parseValueAfter(text, "Z:", z, position);
+}
+
+bool FirmwareResponseParser::parseGrblStatus(std::string_view text, double &x, double &y, double &z) {
+    // "<Idle|MPos:10.000,20.000,0.000|FS:0,0>" oder je nach $10
+    // "<Idle|WPos:0.000,0.000,0.000|FS:0,0|WCO:10.000,20.000,0.000>"
+    if (text.empty() || text.front() != '<') return false;
+
+    double offset[3];
+    if (parseTripleAfter(text, "WCO:", offset)) {
+        std::copy(offset, offset + 3, workOffset);
+    }
+
+    double values[3];
+    if (parseTripleAfter(text, "MPos:", values)) {
+        x = values[0];
+        y = values[1];
+        z = values[2];
+        return true;
+    }
+    if (parseTripleAfter(text, "WPos:", values)) {
+        // MPos = WPos + WCO
+        x = values[0] + workOffset[0];
+        y = values[1] + workOffset[1];
+        z = values[2] + workOffset[2];
+        return true;
+    }
+    return false;
+}
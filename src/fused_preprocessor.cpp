@@ -0,0 +1,187 @@
+#include "fused_preprocessor.h"
+#include <opencv2/core/hal/intrin.hpp>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace {
+
+// BT.601-Gewichte wie COLOR_BGR2GRAY, in 8-Bit-Festkomma (Summe 256), damit
+// die Produkte in 16 Bit passen
+constexpr int WeightB = 29;
+constexpr int WeightG = 150;
+constexpr int WeightR = 77;
+
+// cv::GaussianBlur nutzt für 5x5 ohne Sigma den Binomialkern 1 4 6 4 1 / 16;
+// nach beiden Richtungen ist die Summe höchstens 256 * 255 und passt in 16 Bit
+constexpr int Radius = 2;
+constexpr int Taps = 2 * Radius + 1;
+constexpr float KernelNorm = 1.0f / 256.0f;
+
+struct RowBuffers {
+    std::vector<uchar> gray;    // Grauzeile mit je 'Radius' Randpixeln
+    std::vector<ushort> ring;   // 'Taps' horizontal gefilterte Zeilen
+    int source[Taps];           // Quellzeile im Gesamtbild je Ringplatz, -1 = leer
+};
+
+inline uchar grayPixel(const uchar *pixel) {
+    return uchar((WeightB * pixel[0] + WeightG * pixel[1] + WeightR * pixel[2] + 128) >> 8);
+}
+
+void convertRow(const uchar *bgr, uchar *gray, int width) {
+    int x = 0;
+#if CV_SIMD || CV_SIMD_SCALABLE
+    using namespace cv;
+    const int lanes = VTraits<v_uint8>::vlanes();
+    const v_uint16 wb = vx_setall_u16(WeightB);
+    const v_uint16 wg = vx_setall_u16(WeightG);
+    const v_uint16 wr = vx_setall_u16(WeightR);
+    const v_uint16 half = vx_setall_u16(128);
+    for (; x <= width - lanes; x += lanes) {
+        v_uint8 b, g, r;
+        v_load_deinterleave(bgr + 3 * x, b, g, r);
+        v_uint16 b0, b1, g0, g1, r0, r1;
+        v_expand(b, b0, b1);
+        v_expand(g, g0, g1);
+        v_expand(r, r0, r1);
+        v_uint16 y0 = v_add(v_mul_wrap(b0, wb), v_mul_wrap(g0, wg), v_mul_wrap(r0, wr), half);
+        v_uint16 y1 = v_add(v_mul_wrap(b1, wb), v_mul_wrap(g1, wg), v_mul_wrap(r1, wr), half);
+        v_store(gray + x, v_pack(v_shr<8>(y0), v_shr<8>(y1)));
+    }
+#endif
+    for (; x < width; ++x) {
+        gray[x] = grayPixel(bgr + 3 * x);
+    }
+}
+
+// 'padded' beginnt 'Radius' Pixel links vom ersten Bildpixel
+void filterRow(const uchar *padded, ushort *out, int width) {
+    int x = 0;
+#if CV_SIMD || CV_SIMD_SCALABLE
+    using namespace cv;
+    const int lanes = VTraits<v_uint16>::vlanes();
+    for (; x <= width - lanes; x += lanes) {
+        v_uint16 a0 = vx_load_expand(padded + x);
+        v_uint16 a1 = vx_load_expand(padded + x + 1);
+        v_uint16 a2 = vx_load_expand(padded + x + 2);
+        v_uint16 a3 = vx_load_expand(padded + x + 3);
+        v_uint16 a4 = vx_load_expand(padded + x + 4);
+        v_store(out + x, v_add(a0, a4, v_shl<2>(v_add(a1, a3)), v_shl<2>(a2), v_shl<1>(a2)));
+    }
+#endif
+    for (; x < width; ++x) {
+        out[x] = ushort(padded[x] + padded[x + 4] + 4 * (padded[x + 1] + padded[x + 3]) + 6 * padded[x + 2]);
+    }
+}
+
+#if CV_SIMD || CV_SIMD_SCALABLE
+inline cv::v_int16 scaledColumn(const ushort *const rows[Taps], int x, const cv::v_float32 &scale) {
+    using namespace cv;
+    v_uint16 a0 = vx_load(rows[0] + x);
+    v_uint16 a1 = vx_load(rows[1] + x);
+    v_uint16 a2 = vx_load(rows[2] + x);
+    v_uint16 a3 = vx_load(rows[3] + x);
+    v_uint16 a4 = vx_load(rows[4] + x);
+    v_uint16 sum = v_add(a0, a4, v_shl<2>(v_add(a1, a3)), v_shl<2>(a2), v_shl<1>(a2));
+    v_uint32 low, high;
+    v_expand(sum, low, high);
+    v_int32 q0 = v_round(v_mul(v_cvt_f32(v_reinterpret_as_s32(low)), scale));
+    v_int32 q1 = v_round(v_mul(v_cvt_f32(v_reinterpret_as_s32(high)), scale));
+    return v_pack(q0, q1);
+}
+#endif
+
+// Vertikaler Kern, Normierung und Verstärkung in einem Schritt
+void combineRows(const ushort *const rows[Taps], uchar *out, int width, float scale) {
+    int x = 0;
+#if CV_SIMD || CV_SIMD_SCALABLE
+    using namespace cv;
+    const int lanes = VTraits<v_uint8>::vlanes();
+    const int halfLanes = VTraits<v_uint16>::vlanes();
+    const v_float32 factor = vx_setall_f32(scale);
+    for (; x <= width - lanes; x += lanes) {
+        v_int16 low = scaledColumn(rows, x, factor);
+        v_int16 high = scaledColumn(rows, x + halfLanes, factor);
+        v_store(out + x, v_pack_u(low, high));
+    }
+#endif
+    for (; x < width; ++x) {
+        int sum = rows[0][x] + rows[4][x] + 4 * (rows[1][x] + rows[3][x]) + 6 * rows[2][x];
+        out[x] = cv::saturate_cast<uchar>(sum * scale);
+    }
+}
+
+}
+
+void FusedPreprocessor::apply(const cv::Mat &input, cv::Mat &output, double gain) {
+    if (input.empty() || input.type() != CV_8UC3) {
+        reference(input, output, gain);
+        return;
+    }
+    if (output.data == input.data) {
+        cv::Mat result;
+        apply(input, result, gain);
+        output = result;
+        return;
+    }
+
+    const int width = input.cols;
+    const int height = input.rows;
+    output.create(input.size(), CV_8UC1);
+
+    // Bei einem Ausschnitt liegen die Nachbarn am Rand im Gesamtbild; wie
+    // GaussianBlur ohne BORDER_ISOLATED werden sie gelesen und erst am Rand
+    // des Gesamtbildes gespiegelt
+    cv::Size whole;
+    cv::Point offset;
+    input.locateROI(whole, offset);
+
+    // Nach dem ersten Bild einer Größe wird hier nichts mehr angelegt
+    thread_local RowBuffers buffers;
+    buffers.gray.resize(size_t(width + 2 * Radius));
+    buffers.ring.resize(size_t(width) * Taps);
+    for (int &source : buffers.source) {
+        source = -1;
+    }
+
+    uchar *gray = buffers.gray.data();
+    // convertScaleAbs nimmt den Betrag; die gefilterten Werte sind nie negativ
+    const float scale = float(std::abs(gain)) * KernelNorm;
+    const ushort *rows[Taps];
+
+    for (int y = 0; y < height; ++y) {
+        for (int k = 0; k < Taps; ++k) {
+            // Ränder gespiegelt wie die Voreinstellung von GaussianBlur
+            int source = cv::borderInterpolate(offset.y + y + k - Radius, whole.height, cv::BORDER_REFLECT_101);
+            int slot = source % Taps;
+            ushort *filtered = buffers.ring.data() + size_t(slot) * width;
+
+            if (buffers.source[slot] != source) {
+                // Zeilen und Spalten relativ zum Ausschnitt, auch außerhalb davon
+                const uchar *row = input.data + std::ptrdiff_t(source - offset.y) * std::ptrdiff_t(input.step);
+                convertRow(row, gray + Radius, width);
+                for (int i = 1; i <= Radius; ++i) {
+                    int left = cv::borderInterpolate(offset.x - i, whole.width, cv::BORDER_REFLECT_101);
+                    int right = cv::borderInterpolate(offset.x + width - 1 + i, whole.width, cv::BORDER_REFLECT_101);
+                    gray[Radius - i] = grayPixel(row + 3 * std::ptrdiff_t(left - offset.x));
+                    gray[Radius + width - 1 + i] = grayPixel(row + 3 * std::ptrdiff_t(right - offset.x));
+                }
+                filterRow(gray, filtered, width);
+                buffers.source[slot] = source;
+            }
+            rows[k] = filtered;
+        }
+        combineRows(rows, output.ptr<uchar>(y), width, scale);
+    }
+}
+
+void FusedPreprocessor::reference(const cv::Mat &input, cv::Mat &output, double gain) {
+    // Rauschreduzierung
+    cv::GaussianBlur(input, output, cv::Size(5, 5), 0);
+
+    // Kontrastverstärkung
+    cv::convertScaleAbs(output, output, gain, 0);
+
+    // Graustufen
+    cv::cvtColor(output, output, cv::COLOR_BGR2GRAY);
+}
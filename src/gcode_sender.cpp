@@ -0,0 +1,411 @@
+#include "gcode_sender.h"
+#include "gcode_encoder.h"
+#include <QCoreApplication>
+#include <QDebug>
+#include <algorithm>
+
+namespace {
+// Grbl und Marlin verwenden standardmäßig einen 128-Byte-Empfangspuffer
+constexpr int DefaultRxBufferSize = 128;
+
+// Größe des Lesepuffers; eine Antwortzeile ist selten länger als 100 Byte
+constexpr qint64 ReadChunkSize = 1024;
+
+// Kürzestes Intervall des Marlin-Autoreports (M154 S1)
+constexpr int MarlinAutoReportMinimumMs = 1000;
+
+const char PositionQueryLine[] = "M114\n";
+constexpr int PositionQueryLength = int(sizeof(PositionQueryLine) - 1);
+}
+
+const QEvent::Type GCodeSender::WakeupEvent =
+    static_cast<QEvent::Type>(QEvent::registerEventType());
+const QEvent::Type GCodeSender::EmergencyStopEvent =
+    static_cast<QEvent::Type>(QEvent::registerEventType());
+
+GCodeSender::GCodeSender(QObject *parent)
+    : QObject(parent)
+    , serialPort(new QSerialPort(this))
+    , statusQueryTimer(new QTimer(this))
+    , hasHeldCommand(false)
+    , nextLineNumber(1)
+    , reportMode(PositionReportMode::None)
+    , positionQueryRequested(false)
+    , positionQueryInFlight(false)
+    , wakeupPending(false)
+    , responsesPending(false)
+    , clearRequested(false)
+    , emergencyStopRequested(false)
+    , rxBufferBytes(DefaultRxBufferSize)
+    , linesInFlight(0)
+    , bytesInFlight(0)
+    , linesQueued(0)
+    , linesSent(0)
+    , linesAcknowledged(0)
+    , bytesSent(0)
+    , errorCount(0)
+    , responsesDropped(0)
+    , statisticsStartNs(0)
+{
+    connect(serialPort, &QSerialPort::readyRead, this, &GCodeSender::onReadyRead);
+    connect(statusQueryTimer, &QTimer::timeout, this, &GCodeSender::queryStatus);
+    clock.start();
+}
+
+GCodeSender::~GCodeSender() {
+    closePort();
+}
+
+bool GCodeSender::openPort(const QString &portName, qint32 baudRate) {
+    serialPort->setPortName(portName);
+    serialPort->setBaudRate(baudRate);
+    serialPort->setDataBits(QSerialPort::Data8);
+    serialPort->setParity(QSerialPort::NoParity);
+    serialPort->setStopBits(QSerialPort::OneStop);
+    serialPort->setFlowControl(QSerialPort::NoFlowControl);
+
+    if (!serialPort->open(QIODevice::ReadWrite)) {
+        qDebug() << "Fehler beim Öffnen des seriellen Ports:" << serialPort->errorString();
+        return false;
+    }
+    return true;
+}
+
+void GCodeSender::closePort() {
+    statusQueryTimer->stop();
+    if (serialPort->isOpen()) {
+        serialPort->close();
+    }
+    responseParser.reset();
+}
+
+void GCodeSender::setRxBufferSize(int bytes) {
+    rxBufferBytes.store(std::max(16, bytes));
+    scheduleWakeup();
+}
+
+int GCodeSender::rxBufferSize() const {
+    return rxBufferBytes.load();
+}
+
+bool GCodeSender::submit(const GCodeCommand &command) {
+    if (!commandRing.push(command)) {
+        return false; // Ring voll, der Produzent muss es später erneut versuchen
+    }
+    linesQueued.fetch_add(1, std::memory_order_relaxed);
+    scheduleWakeup();
+    return true;
+}
+
+void GCodeSender::clear() {
+    // Nur noch nicht gesendete Zeilen verwerfen; die Firmware bestätigt die
+    // bereits übertragenen trotzdem
+    clearRequested.store(true);
+    scheduleWakeup();
+}
+
+void GCodeSender::requestEmergencyStop() {
+    emergencyStopRequested.store(true);
+    QCoreApplication::postEvent(this, new QEvent(EmergencyStopEvent), Qt::HighEventPriority);
+}
+
+bool GCodeSender::pollResponse(SerialResponse &response) {
+    if (responseRing.pop(response)) {
+        return true;
+    }
+
+    // Ring leer: Benachrichtigung wieder scharf schalten und erneut prüfen,
+    // damit keine gleichzeitig eingetroffene Antwort verloren geht
+    responsesPending.store(false);
+    if (responseRing.pop(response)) {
+        responsesPending.store(true);
+        return true;
+    }
+    return false;
+}
+
+int GCodeSender::queueDepth() const {
+    return int(commandRing.size());
+}
+
+int GCodeSender::pendingAcknowledgements() const {
+    return linesInFlight.load(std::memory_order_relaxed);
+}
+
+bool GCodeSender::isIdle() const {
+    return commandRing.empty() && linesInFlight.load() == 0;
+}
+
+GCodeSenderStatistics GCodeSender::statistics() const {
+    GCodeSenderStatistics result;
+    result.linesQueued = linesQueued.load(std::memory_order_relaxed);
+    result.linesSent = linesSent.load(std::memory_order_relaxed);
+    result.linesAcknowledged = linesAcknowledged.load(std::memory_order_relaxed);
+    result.bytesSent = bytesSent.load(std::memory_order_relaxed);
+    result.errors = errorCount.load(std::memory_order_relaxed);
+    result.responsesDropped = responsesDropped.load(std::memory_order_relaxed);
+    result.queueDepth = queueDepth();
+    result.linesInFlight = linesInFlight.load(std::memory_order_relaxed);
+    result.bytesInFlight = bytesInFlight.load(std::memory_order_relaxed);
+
+    double seconds = (clock.nsecsElapsed() - statisticsStartNs.load()) / 1e9;
+    result.linesPerSecond = seconds > 0.0 ? result.linesAcknowledged / seconds : 0.0;
+    result.latencyP50Us = ackLatencyUs.percentile(50.0);
+    result.latencyP99Us = ackLatencyUs.percentile(99.0);
+    result.latencyMaxUs = ackLatencyUs.maximum();
+    return result;
+}
+
+void GCodeSender::resetStatistics() {
+    linesQueued.store(0);
+    linesSent.store(0);
+    linesAcknowledged.store(0);
+    bytesSent.store(0);
+    errorCount.store(0);
+    responsesDropped.store(0);
+    ackLatencyUs.reset();
+    statisticsStartNs.store(clock.nsecsElapsed());
+}
+
+void GCodeSender::setPositionReporting(PositionReportMode mode, int intervalMs) {
+    int interval = std::max(10, intervalMs);
+    // M154 kennt nur ganze Sekunden; kürzere Intervalle fragt der Sender
+    // stattdessen mit M114 ab
+    bool marlinPolling = mode == PositionReportMode::MarlinAutoReport && interval < MarlinAutoReportMinimumMs;
+
+    // Der Timer gehört dem I/O-Thread und wird nur dort gestartet
+    QMetaObject::invokeMethod(this, [this, mode, interval, marlinPolling]() {
+        reportMode = mode;
+        positionQueryRequested = false;
+        if (mode == PositionReportMode::GrblStatusQuery || marlinPolling) {
+            statusQueryTimer->start(interval);
+        } else {
+            statusQueryTimer->stop();
+        }
+    }, Qt::QueuedConnection);
+
+    if (mode == PositionReportMode::MarlinAutoReport) {
+        GCodeCommand command;
+        GCodeLineWriter(command).literal("M154")
+            .word<'S'>(marlinPolling ? 0LL : (interval + 500LL) / 1000LL)
+            .finish();
+        submit(command);
+    }
+}
+
+MachinePosition GCodeSender::machinePosition() const {
+    return reportedPosition.load();
+}
+
+bool GCodeSender::event(QEvent *event) {
+    if (event->type() == EmergencyStopEvent) {
+        performEmergencyStop();
+        return true;
+    }
+
+    if (event->type() == WakeupEvent) {
+        wakeupPending.store(false);
+        performEmergencyStop();
+
+        if (clearRequested.exchange(false)) {
+            GCodeCommand discarded;
+            while (commandRing.pop(discarded)) {}
+            hasHeldCommand = false;
+        }
+
+        fillRxBuffer();
+        return true;
+    }
+
+    return QObject::event(event);
+}
+
+void GCodeSender::scheduleWakeup() {
+    // Mehrere Produzenten teilen sich ein einziges ausstehendes Weck-Ereignis
+    if (!wakeupPending.exchange(true)) {
+        QCoreApplication::postEvent(this, new QEvent(WakeupEvent));
+    }
+}
+
+void GCodeSender::fillRxBuffer() {
+    if (!serialPort->isOpen()) return;
+
+    // Zeilen senden, solange sie vollständig in den Firmware-Puffer passen.
+    // Eine einzelne überlange Zeile wird nur bei leerem Puffer gesendet.
+    int bufferSize = rxBufferBytes.load();
+    if (positionQueryRequested && !sendPositionQuery(bufferSize)) return;
+
+    while (true) {
+        if (!hasHeldCommand) {
+            if (!commandRing.pop(heldCommand)) break;
+            hasHeldCommand = true;
+        }
+
+        int length = heldCommand.length;
+        bool fits = bytesInFlight.load(std::memory_order_relaxed) + length <= bufferSize;
+        if (!fits && !inFlightLines.isEmpty()) break;
+
+        if (serialPort->write(heldCommand.text, length) != length) {
+            errorCount.fetch_add(1, std::memory_order_relaxed);
+            emit errorOccurred("Fehler beim Senden des G-Code: " + serialPort->errorString());
+            return;
+        }
+
+        inFlightLines.enqueue(InFlightLine{nextLineNumber++, length, clock.nsecsElapsed() / 1000, false});
+        bytesInFlight.fetch_add(length, std::memory_order_relaxed);
+        updateLinesInFlight();
+        linesSent.fetch_add(1, std::memory_order_relaxed);
+        bytesSent.fetch_add(length, std::memory_order_relaxed);
+        hasHeldCommand = false;
+    }
+}
+
+bool GCodeSender::sendPositionQuery(int bufferSize) {
+    // Die Abfrage überholt die wartenden Zeilen im Ring; sie wartet nur
+    // hinter dem, was bereits im Empfangspuffer der Firmware liegt
+    bool fits = bytesInFlight.load(std::memory_order_relaxed) + PositionQueryLength <= bufferSize;
+    if (!fits && !inFlightLines.isEmpty()) return true;
+
+    if (serialPort->write(PositionQueryLine, PositionQueryLength) != PositionQueryLength) {
+        errorCount.fetch_add(1, std::memory_order_relaxed);
+        emit errorOccurred("Fehler beim Senden der Positionsabfrage: " + serialPort->errorString());
+        return false;
+    }
+
+    inFlightLines.enqueue(InFlightLine{0, PositionQueryLength, clock.nsecsElapsed() / 1000, true});
+    bytesInFlight.fetch_add(PositionQueryLength, std::memory_order_relaxed);
+    positionQueryRequested = false;
+    positionQueryInFlight = true;
+    return true;
+}
+
+void GCodeSender::updateLinesInFlight() {
+    // Die eingeschobene Abfrage zählt nicht als offene Zeile, sonst hielte
+    // sie isIdle() und die Freigabe des Handbetriebs auf
+    int lines = inFlightLines.size() - (positionQueryInFlight ? 1 : 0);
+    linesInFlight.store(lines, std::memory_order_relaxed);
+}
+
+void GCodeSender::onReadyRead() {
+    // Direkt in einen Stackpuffer lesen und zeilenweise auswerten, ohne
+    // pro Zeile ein QByteArray anzulegen
+    char chunk[ReadChunkSize];
+    qint64 bytesRead;
+    while ((bytesRead = serialPort->read(chunk, ReadChunkSize)) > 0) {
+        responseParser.feed(chunk, std::size_t(bytesRead),
+                            [this](const FirmwareResponseParser::Line &line) {
+            handleResponseLine(line);
+        });
+    }
+
+    fillRxBuffer();
+    if (isIdle() && !hasHeldCommand) {
+        emit queueDrained();
+    }
+}
+
+void GCodeSender::queryStatus() {
+    if (!serialPort->isOpen()) return;
+
+    if (reportMode == PositionReportMode::MarlinAutoReport) {
+        // M114 belegt Platz im Empfangspuffer und wird mit "ok" bestätigt;
+        // höchstens eine Abfrage offen halten, bis ihr "ok" eingetroffen ist
+        if (positionQueryInFlight) return;
+        positionQueryRequested = true;
+        fillRxBuffer();
+        return;
+    }
+
+    // '?' ist ein Echtzeitbefehl: Grbl wertet ihn sofort aus, er belegt
+    // keinen Platz im Empfangspuffer und wird nicht mit "ok" bestätigt
+    serialPort->write("?", 1);
+}
+
+void GCodeSender::handleResponseLine(const FirmwareResponseParser::Line &line) {
+    switch (line.type) {
+    case FirmwareResponseParser::LineType::Ok:
+        releaseOldestLine(false, line.text);
+        break;
+    case FirmwareResponseParser::LineType::Error:
+        releaseOldestLine(true, line.text);
+        emit errorOccurred("Firmware meldet Fehler: " +
+                           QString::fromLatin1(line.text.data(), qsizetype(line.text.size())));
+        break;
+    case FirmwareResponseParser::LineType::Position:
+        // Positionsmeldungen gehen nicht durch den Antwort-Ring, sondern
+        // überschreiben nur den Schnappschuss
+        reportedPosition.store(line.x, line.y, line.z, clock.nsecsElapsed());
+        break;
+    case FirmwareResponseParser::LineType::Other: {
+        SerialResponse response;
+        response.type = SerialResponse::Message;
+        response.setText(line.text);
+        publishResponse(response);
+        break;
+    }
+    }
+}
+
+void GCodeSender::releaseOldestLine(bool isError, std::string_view line) {
+    if (inFlightLines.isEmpty()) {
+        qDebug() << "Unerwartete Bestätigung ohne offene Zeile";
+        return;
+    }
+
+    InFlightLine acked = inFlightLines.dequeue();
+    bytesInFlight.fetch_sub(acked.length, std::memory_order_relaxed);
+    if (acked.positionQuery) {
+        // Bestätigung der eigenen Abfrage, nicht an die Produzenten weitergeben
+        positionQueryInFlight = false;
+        updateLinesInFlight();
+        return;
+    }
+    updateLinesInFlight();
+
+    SerialResponse response;
+    response.type = isError ? SerialResponse::Error : SerialResponse::Acknowledged;
+    response.lineNumber = acked.lineNumber;
+    response.latencyUs = clock.nsecsElapsed() / 1000 - acked.sentAtUs;
+    response.setText(line);
+
+    if (isError) {
+        errorCount.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        linesAcknowledged.fetch_add(1, std::memory_order_relaxed);
+        ackLatencyUs.record(quint64(std::max<qint64>(0, response.latencyUs)));
+    }
+    publishResponse(response);
+}
+
+void GCodeSender::publishResponse(const SerialResponse &response) {
+    if (!responseRing.push(response)) {
+        responsesDropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    // Nur ein Signal pro Abholrunde, statt einem pro Antwort
+    if (!responsesPending.exchange(true)) {
+        emit responsesAvailable();
+    }
+}
+
+void GCodeSender::performEmergencyStop() {
+    if (!emergencyStopRequested.exchange(false)) return;
+
+    // Sofort-Stopp an allen wartenden Befehlen vorbei schreiben
+    if (serialPort->isOpen()) {
+        static const char stopSequence[] = "M112\nM18\n";
+        serialPort->write(stopSequence, sizeof(stopSequence) - 1);
+        serialPort->flush();
+    }
+
+    // Wartende Befehle verwerfen; die Firmware bestätigt nach M112 nichts mehr
+    GCodeCommand discarded;
+    while (commandRing.pop(discarded)) {}
+    hasHeldCommand = false;
+    inFlightLines.clear();
+    positionQueryRequested = false;
+    positionQueryInFlight = false;
+    bytesInFlight.store(0);
+    linesInFlight.store(0);
+}
@@ -1,7 +1,9 @@
 #include "gui.h"
+#include "loop_instrumentation.h"
 #include "motion_controller.h"
 #include "sensor_manager.h"
 #include "temperature_control.h"
+#include <QDir>
 #include <QMessageBox>
 #include <QGroupBox>
 
@@ -10,18 +12,38 @@ MainWindow::MainWindow(QWidget *parent)
     , motionController(new MotionController(this))
     , sensorManager(new SensorManager(this))
     , temperatureControl(new TemperatureControl(this))
+    , loopReporter(new LoopStatisticsReporter(this))
 {
+    // Weitere Heizkreise der Zelle und Leistungsbudget; die Lötspitze hat
+    // Vorrang im Budget
+    temperatureControl->loadHeaterConfiguration(QDir::current().filePath("config/temperature.json"));
+    preheaterChannel = temperatureControl->heaterChannel("preheater");
+    feedWarmerChannel = temperatureControl->heaterChannel("feedWarmer");
+
     setupUI();
 
-    // Verbindungen für Sicherheitsfunktionen
+    // Verbindungen für Sicherheitsfunktionen. Der Stopp läuft direkt im
+    // Sensorthread über die thread-sicheren Wege von Bewegung und Heizung,
+    // ohne auf die Ereignisschleife der Oberfläche zu warten.
+    connect(sensorManager, &SensorManager::obstacleDetected, motionController,
+            [motion = motionController, heating = temperatureControl](bool detected) {
+        if (detected) {
+            motion->requestEmergencyStop();
+            heating->enableHeating(false);
+        }
+    }, Qt::DirectConnection);
+
+    // Aufräumen und Warnung danach im Thread der Oberfläche
     connect(sensorManager, &SensorManager::obstacleDetected, this, [this](bool detected) {
         if (detected) {
-            emergencyStop();
+            motionController->emergencyStop();
             QMessageBox::warning(this, "Sicherheitswarnung", 
                 "Hindernis erkannt! Bewegung gestoppt.");
         }
     });
 
+    connect(sensorManager, &SensorManager::samplingOverrun, this, &MainWindow::updateSamplingStatus);
+
     // Initialisierung der Komponenten
     if (!motionController->initialize()) {
         QMessageBox::critical(this, "Fehler", 
@@ -37,6 +59,14 @@ MainWindow::MainWindow(QWidget *parent)
         QMessageBox::critical(this, "Fehler", 
             "Sensoren konnten nicht initialisiert werden.");
     }
+
+    // Zeitverhalten der Regel- und Sensorschleifen protokollieren
+    loopReporter->addProbe(&temperatureControl->controlLoopProbe());
+    for (LoopProbe *probe : sensorManager->loopProbes()) {
+        loopReporter->addProbe(probe);
+    }
+    loopReporter->setResetAfterDump(true);
+    loopReporter->start(60000);
 }
 
 MainWindow::~MainWindow() {
@@ -105,11 +135,14 @@ void MainWindow::createAxisControls() {
     layout->addWidget(zPosDisplay, 2, 1);
     layout->addWidget(zSpinBox, 2, 2);
     
-    // Bewegungssteuerung verbinden
-    connect(xSpinBox, QOverload<double>::of(&QDoubleSpinBox::valueChanged),
-            [this, ySpinBox, zSpinBox](double x) {
-        motionController->moveToPosition(x, ySpinBox->value(), zSpinBox->value());
-    });
+    // Bewegungssteuerung verbinden; beim Halten der Pfeiltasten ersetzt jedes
+    // neue Ziel das noch nicht gesendete vorherige
+    auto jog = [this, xSpinBox, ySpinBox, zSpinBox]() {
+        motionController->jogTo(xSpinBox->value(), ySpinBox->value(), zSpinBox->value());
+    };
+    connect(xSpinBox, QOverload<double>::of(&QDoubleSpinBox::valueChanged), this, jog);
+    connect(ySpinBox, QOverload<double>::of(&QDoubleSpinBox::valueChanged), this, jog);
+    connect(zSpinBox, QOverload<double>::of(&QDoubleSpinBox::valueChanged), this, jog);
     
     static_cast<QVBoxLayout*>(centralWidget->layout())->addWidget(groupBox);
 }
@@ -124,12 +157,50 @@ void MainWindow::createTemperatureControls() {
     tempSpinBox->setRange(0, 450);
     tempSpinBox->setValue(350); // Standard-Löttemperatur
     
+    // Relaisversuch um die eingestellte Temperatur
+    auto autotuneButton = new QPushButton("Autotuning", this);
+    
+    auto preheaterLabel = new QLabel("Vorheizung (°C):", this);
+    auto preheaterSpinBox = new QDoubleSpinBox(this);
+    preheaterSpinBox->setRange(0, temperatureControl->heaterChannelSettings(preheaterChannel).maxTemperature);
+    preheaterSpinBox->setEnabled(preheaterChannel >= 0);
+    
+    auto feedWarmerLabel = new QLabel("Lotvorwärmung (°C):", this);
+    auto feedWarmerSpinBox = new QDoubleSpinBox(this);
+    feedWarmerSpinBox->setRange(0, temperatureControl->heaterChannelSettings(feedWarmerChannel).maxTemperature);
+    feedWarmerSpinBox->setEnabled(feedWarmerChannel >= 0);
+    
     layout->addWidget(tempLabel);
     layout->addWidget(temperatureDisplay);
     layout->addWidget(tempSpinBox);
+    layout->addWidget(autotuneButton);
+    layout->addWidget(preheaterLabel);
+    layout->addWidget(preheaterSpinBox);
+    layout->addWidget(feedWarmerLabel);
+    layout->addWidget(feedWarmerSpinBox);
     
     connect(tempSpinBox, QOverload<double>::of(&QDoubleSpinBox::valueChanged),
             temperatureControl, &TemperatureControl::setTargetTemperature);
+    connect(preheaterSpinBox, QOverload<double>::of(&QDoubleSpinBox::valueChanged), this,
+            [this](double value) { temperatureControl->setChannelTarget(preheaterChannel, value); });
+    connect(feedWarmerSpinBox, QOverload<double>::of(&QDoubleSpinBox::valueChanged), this,
+            [this](double value) { temperatureControl->setChannelTarget(feedWarmerChannel, value); });
+    connect(autotuneButton, &QPushButton::clicked, this, [this, autotuneButton]() {
+        if (temperatureControl->startAutotune()) {
+            autotuneButton->setEnabled(false);
+        } else {
+            QMessageBox::warning(this, "Autotuning",
+                "Autotuning nicht möglich. Heizung freigeben und Zieltemperatur einstellen.");
+        }
+    });
+    connect(temperatureControl, &TemperatureControl::autotuneFinished, this,
+            [this, autotuneButton](bool success) {
+        autotuneButton->setEnabled(true);
+        if (!success) {
+            QMessageBox::warning(this, "Autotuning",
+                "Autotuning abgebrochen oder fehlgeschlagen. Bisherige Reglerparameter bleiben aktiv.");
+        }
+    });
     
     static_cast<QVBoxLayout*>(centralWidget->layout())->addWidget(groupBox);
 }
@@ -151,7 +222,7 @@ void MainWindow::createConveyorControls() {
     connect(conveyorSpeedSlider, &QSlider::valueChanged, 
             [this, speedDisplay](int value) {
         speedDisplay->display(value);
-        motionController->setConveyorSpeed(value);
+        motionController->jogConveyor(value);
     });
     
     static_cast<QVBoxLayout*>(centralWidget->layout())->addWidget(groupBox);
@@ -172,6 +243,11 @@ void MainWindow::createSensorDisplay() {
     layout->addWidget(magnetLabel, 1, 0);
     layout->addWidget(magnetDisplay, 1, 1);
     
+    auto samplingLabel = new QLabel("Abtastung:", this);
+    samplingStatusLabel = new QLabel("OK", this);
+    layout->addWidget(samplingLabel, 2, 0);
+    layout->addWidget(samplingStatusLabel, 2, 1);
+    
     // Aktualisierung der Sensorwerte
     QTimer *updateTimer = new QTimer(this);
     connect(updateTimer, &QTimer::timeout, [=]() {
@@ -197,6 +273,11 @@ void MainWindow::updateConveyorSpeed(int speed) {
     conveyorSpeedSlider->setValue(speed);
 }
 
+void MainWindow::updateSamplingStatus(const QString &sensor, quint64 totalOverruns) {
+    samplingStatusLabel->setText(QString("%1: Frist %2-mal überschritten").arg(sensor).arg(totalOverruns));
+    samplingStatusLabel->setStyleSheet("color: red;");
+}
+
 void MainWindow::emergencyStop() {
     motionController->emergencyStop();
     temperatureControl->enableHeating(false);
@@ -0,0 +1,150 @@
+#include "heater_bank.h"
+#include <algorithm>
+#include <limits>
+
+int HeaterBank::addChannel(const HeaterChannelSettings &settings) {
+    if (count >= MaxChannels) return -1;
+
+    int channel = count++;
+    configure(channel, settings);
+    reset(channel);
+    return channel;
+}
+
+void HeaterBank::configure(int channel, const HeaterChannelSettings &settings) {
+    ratedPower[channel] = std::max(0.0, settings.ratedPower);
+    maxPower[channel] = std::clamp(settings.maxPower, 0.0, 100.0);
+    maxTemperature[channel] = settings.maxTemperature;
+    priority[channel] = settings.priority;
+    setGains(channel, settings.gains);
+    integral[channel] = std::min(integral[channel], maxPower[channel]);
+}
+
+void HeaterBank::setGains(int channel, const PIDGains &gains) {
+    // Stoßfrei: der bisher aufintegrierte Anteil bleibt erhalten
+    parameters[channel] = gains;
+    parameters[channel].derivativeFilter = std::max(0.0, gains.derivativeFilter);
+}
+
+void HeaterBank::reset(int channel) {
+    integral[channel] = 0.0;
+    candidateIntegral[channel] = 0.0;
+    filteredDerivative[channel] = 0.0;
+    lastMeasurement[channel] = 0.0;
+    hasLastMeasurement[channel] = false;
+}
+
+void HeaterBank::setIntegral(int channel, double value) {
+    integral[channel] = std::clamp(value, 0.0, maxPower[channel]);
+}
+
+void HeaterBank::setInput(int channel, bool enable, double setpoint, double measured, double feedForward) {
+    enabled[channel] = enable;
+    setpoints[channel] = std::min(setpoint, maxTemperature[channel]);
+    measurements[channel] = measured;
+    feedForwards[channel] = feedForward;
+}
+
+void HeaterBank::setOverride(int channel, double power) {
+    overridden[channel] = true;
+    overridePower[channel] = std::clamp(power, 0.0, maxPower[channel]);
+}
+
+void HeaterBank::update(double dt) {
+    // Regelgesetz je Kreis: angeforderte Stellgröße und Leistung
+    for (int c = 0; c < count; ++c) {
+        limited[c] = false;
+        if (!enabled[c]) {
+            wasEnabled[c] = false;
+            overridden[c] = false;
+            requests[c] = 0.0;
+            outputs[c] = 0.0;
+            continue;
+        }
+
+        // Nach dem Einschalten ohne alte Integral- und Differenzanteile starten
+        if (!wasEnabled[c]) {
+            reset(c);
+            wasEnabled[c] = true;
+        }
+
+        const PIDGains &gains = parameters[c];
+        double error = setpoints[c] - measurements[c];
+
+        // D-Anteil auf den Messwert; im ersten Zyklus gibt es noch keine Änderungsrate
+        if (dt > 0.0 && hasLastMeasurement[c]) {
+            double rate = -(measurements[c] - lastMeasurement[c]) / dt;
+            double alpha = dt / (gains.derivativeFilter + dt);
+            filteredDerivative[c] += alpha * (rate - filteredDerivative[c]);
+        }
+        lastMeasurement[c] = measurements[c];
+        hasLastMeasurement[c] = true;
+
+        double demand;
+        if (overridden[c]) {
+            candidateIntegral[c] = integral[c];
+            demand = overridePower[c];
+        } else {
+            double candidate = integral[c] + gains.ki * error * std::max(dt, 0.0);
+            double unclamped = gains.kp * error + candidate + gains.kd * filteredDerivative[c] + feedForwards[c];
+
+            // Anti-Windup: in der Begrenzung nur integrieren, wenn der Fehler
+            // aus ihr herausführt
+            bool saturatedHigh = unclamped > maxPower[c] && error > 0.0;
+            bool saturatedLow = unclamped < 0.0 && error < 0.0;
+            candidateIntegral[c] = saturatedHigh || saturatedLow
+                ? integral[c] : std::clamp(candidate, -maxPower[c], maxPower[c]);
+
+            demand = std::clamp(gains.kp * error + candidateIntegral[c] +
+                                gains.kd * filteredDerivative[c] + feedForwards[c],
+                                0.0, maxPower[c]);
+        }
+        outputs[c] = demand;
+        requests[c] = demand / 100.0 * ratedPower[c];
+    }
+
+    // Budget nach absteigender Priorität verteilen
+    if (budget > 0.0) {
+        double remaining = budget;
+        int previousLevel = std::numeric_limits<int>::max();
+        while (true) {
+            bool found = false;
+            int level = std::numeric_limits<int>::min();
+            for (int c = 0; c < count; ++c) {
+                if (requests[c] > 0.0 && priority[c] < previousLevel && priority[c] >= level) {
+                    level = priority[c];
+                    found = true;
+                }
+            }
+            if (!found) break;
+
+            double sum = 0.0;
+            for (int c = 0; c < count; ++c) {
+                if (requests[c] > 0.0 && priority[c] == level) sum += requests[c];
+            }
+            if (sum > remaining) {
+                double scale = remaining / sum;
+                for (int c = 0; c < count; ++c) {
+                    if (requests[c] > 0.0 && priority[c] == level) {
+                        outputs[c] *= scale;
+                        limited[c] = true;
+                    }
+                }
+                sum = remaining;
+            }
+            remaining -= sum;
+            previousLevel = level;
+        }
+    }
+
+    // I-Anteil übernehmen; ein vom Budget gekürzter Kreis darf nicht weiter
+    // nach oben integrieren
+    total = 0.0;
+    for (int c = 0; c < count; ++c) {
+        if (enabled[c]) {
+            integral[c] = limited[c] ? std::min(integral[c], candidateIntegral[c]) : candidateIntegral[c];
+        }
+        overridden[c] = false;
+        total += outputs[c] / 100.0 * ratedPower[c];
+    }
+}
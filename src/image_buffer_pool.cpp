@@ -0,0 +1,91 @@
+#include "image_buffer_pool.h"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+struct ImageBufferPool::Core {
+    struct Slot {
+        cv::Mat buffer;
+        // Einmal je Auflösung angelegt; ausgegeben werden nur Kopien davon
+        QImage image;
+    };
+
+    explicit Core(int capacity)
+        : entries(new Slot[capacity])
+        , count(capacity)
+        , references(1)
+    {
+    }
+
+    // Der Pool selbst und jedes zwischengespeicherte Bild halten eine Referenz
+    void release() {
+        if (references.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            delete this;
+        }
+    }
+
+    static void releaseImage(void *info) {
+        static_cast<Core *>(info)->release();
+    }
+
+    // Frei, solange nur der Pool das Bild hält
+    static bool isFree(const Slot &slot) {
+        return slot.image.isNull() || slot.image.isDetached();
+    }
+
+    std::unique_ptr<Slot[]> entries;
+    int count;
+    std::atomic<int> references;
+};
+
+ImageBufferPool::ImageBufferPool(int capacity)
+    : core(new Core(std::max(1, capacity)))
+{
+}
+
+ImageBufferPool::~ImageBufferPool() {
+    // Bilder, die noch bei Empfängern liegen, geben den Kern später frei
+    for (int i = 0; i < core->count; ++i) {
+        core->entries[i].image = QImage();
+    }
+    core->release();
+}
+
+bool ImageBufferPool::acquire(cv::Size size, cv::Mat &pixels, QImage &image) {
+    for (int i = 0; i < core->count; ++i) {
+        Core::Slot &slot = core->entries[i];
+        if (!Core::isFree(slot)) {
+            continue;
+        }
+        // Die letzte Kopie wurde womöglich in einem anderen Thread freigegeben;
+        // deren Lesezugriffe auf den Puffer müssen abgeschlossen sein
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        // Puffer und QImage nur bei geänderter Auflösung neu anlegen
+        if (slot.image.isNull() || slot.buffer.size() != size) {
+            slot.image = QImage();
+            slot.buffer.create(size, CV_8UC3);
+            core->references.fetch_add(1, std::memory_order_relaxed);
+            slot.image = QImage(slot.buffer.data, slot.buffer.cols, slot.buffer.rows,
+                                qsizetype(slot.buffer.step), QImage::Format_RGB888,
+                                &Core::releaseImage, core);
+        }
+
+        pixels = slot.buffer;
+        image = slot.image;
+        return true;
+    }
+    return false;
+}
+
+int ImageBufferPool::capacity() const {
+    return core->count;
+}
+
+int ImageBufferPool::available() const {
+    int free = 0;
+    for (int i = 0; i < core->count; ++i) {
+        if (Core::isFree(core->entries[i])) ++free;
+    }
+    return free;
+}
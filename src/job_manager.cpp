@@ -5,6 +5,44 @@
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QDebug>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+// Nearest-Neighbor ab dem Punkt, der 'start' am nächsten liegt
+// Ab dem ersten Punkt jeweils den günstigsten noch offenen Punkt anfahren;
+// 'cost(von, nach)' bewertet einen Schritt
+template <typename Cost>
+QVector<SolderPoint> nearestNeighbourSequence(const QVector<SolderPoint> &points, Cost cost) {
+    QVector<SolderPoint> sequence;
+    sequence.reserve(points.size());
+    QVector<bool> visited(points.size(), false);
+    int lastIndex = 0;
+    visited[0] = true;
+    sequence.append(points[0]);
+
+    for (int count = 1; count < points.size(); ++count) {
+        double minCost = std::numeric_limits<double>::max();
+        int nextIndex = -1;
+
+        for (int i = 0; i < points.size(); ++i) {
+            if (!visited[i]) {
+                double stepCost = cost(points[lastIndex], points[i]);
+                if (nextIndex < 0 || stepCost < minCost) {
+                    minCost = stepCost;
+                    nextIndex = i;
+                }
+            }
+        }
+
+        sequence.append(points[nextIndex]);
+        visited[nextIndex] = true;
+        lastIndex = nextIndex;
+    }
+    return sequence;
+}
+}
 
 JobManager::JobManager(QObject *parent)
     : QObject(parent)
@@ -186,7 +224,8 @@ bool JobManager::startJob(const QString &jobId) {
     }
 
     // Optimale Reihenfolge der Lötpunkte berechnen
-    optimizePointSequence(job.points);
+    SequencingReport report = optimizePointSequence(job.points);
+    emit sequenceOptimized(jobId, report);
 
     currentJobId = jobId;
     isJobRunning = true;
@@ -413,38 +452,86 @@ bool JobManager::calculatePCBTransform(const PCBData &pcb, QTransform &transform
     return true;
 }
 
-void JobManager::optimizePointSequence(QVector<SolderPoint> &points) {
-    // Nearest-Neighbor-Algorithmus für die Optimierung der Reihenfolge
-    if (points.size() < 2) return;
-    
-    QVector<SolderPoint> optimized;
-    QVector<bool> visited(points.size(), false);
-    optimized.append(points[0]);
-    visited[0] = true;
-    
-    while (optimized.size() < points.size()) {
-        int lastIndex = optimized.size() - 1;
-        QVector3D lastPos = optimized[lastIndex].position;
-        
-        // Nächsten nächstgelegenen Punkt finden
-        double minDist = std::numeric_limits<double>::max();
-        int nextIndex = -1;
-        
-        for (int i = 0; i < points.size(); ++i) {
-            if (!visited[i]) {
-                double dist = (points[i].position - lastPos).length();
-                if (dist < minDist) {
-                    minDist = dist;
-                    nextIndex = i;
-                }
-            }
+void JobManager::setSequencingSettings(const SequencingSettings &settings) {
+    sequencing = settings;
+    sequencing.travelSpeed = std::max(0.1, settings.travelSpeed);
+    sequencing.temperatureTolerance = std::max(0.0, settings.temperatureTolerance);
+}
+
+SequencingSettings JobManager::sequencingSettings() const {
+    return sequencing;
+}
+
+double JobManager::transitionTime(const SolderPoint &from, const SolderPoint &to) const {
+    double travel = (to.position - from.position).length() / sequencing.travelSpeed;
+    if (std::abs(to.temperature - from.temperature) <= sequencing.temperatureTolerance) {
+        return travel;
+    }
+
+    // Der Sollwert wird während der Fahrt vorgezogen (TemperatureControl),
+    // gewartet wird nur, wenn der Wechsel länger dauert als die Fahrt
+    double ramp = sequencing.heater.rampTime(from.temperature, to.temperature) + sequencing.settleTime;
+    return std::max(travel, ramp);
+}
+
+double JobManager::predictCycleTime(const QVector<SolderPoint> &points) const {
+    double cycleTime = 0.0;
+    for (int i = 0; i < points.size(); ++i) {
+        cycleTime += sequencing.approachTime + points[i].dwellTime / 1000.0;
+        if (i > 0) {
+            cycleTime += transitionTime(points[i - 1], points[i]);
         }
-        
-        if (nextIndex != -1) {
-            optimized.append(points[nextIndex]);
-            visited[nextIndex] = true;
+    }
+    // Zurück zum Anfang der nächsten Platine
+    if (points.size() > 1) {
+        cycleTime += transitionTime(points.last(), points.first());
+    }
+    return cycleTime;
+}
+
+int JobManager::countTemperatureChanges(const QVector<SolderPoint> &points) const {
+    int changes = 0;
+    for (int i = 1; i < points.size(); ++i) {
+        if (std::abs(points[i].temperature - points[i - 1].temperature) > sequencing.temperatureTolerance) {
+            ++changes;
         }
     }
-    
+    return changes;
+}
+
+SequencingReport JobManager::optimizePointSequence(QVector<SolderPoint> &points) {
+    SequencingReport report;
+    if (points.size() < 2) return report;
+
+    // Nearest-Neighbor-Algorithmus ab dem ersten Punkt als Vergleichsbasis
+    QVector<SolderPoint> nearest = nearestNeighbourSequence(points,
+        [](const SolderPoint &from, const SolderPoint &to) {
+            return (to.position - from.position).length();
+        });
+    report.nearestNeighbourCycleTime = predictCycleTime(nearest);
+    report.nearestNeighbourTemperatureChanges = countTemperatureChanges(nearest);
+
+    QVector<SolderPoint> optimized = nearest;
+    if (sequencing.mode == SequencingMode::TransitionTime) {
+        // Schritte nach der Übergangszeit laut Heizmodell bewerten: Aufheizen
+        // geht mit der verfügbaren Leistung, Abkühlen nur über die Verluste,
+        // daher werden Temperaturwechsel je nach Richtung unterschiedlich teuer
+        QVector<SolderPoint> timed = nearestNeighbourSequence(points,
+            [this](const SolderPoint &from, const SolderPoint &to) {
+                return transitionTime(from, to);
+            });
+
+        // Nur übernehmen, wenn die Reihenfolge laut Modell tatsächlich schneller ist
+        double timedCycleTime = predictCycleTime(timed);
+        if (timedCycleTime < report.nearestNeighbourCycleTime) {
+            optimized = timed;
+            report.mode = SequencingMode::TransitionTime;
+        }
+    }
+
+    report.cycleTime = predictCycleTime(optimized);
+    report.temperatureChanges = countTemperatureChanges(optimized);
+
     points = optimized;
+    return report;
 }
@@ -0,0 +1,90 @@
+#include "latency_histogram.h"
+#include <QtAlgorithms>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+int mostSignificantBit(std::uint64_t value) {
+    return 63 - int(qCountLeadingZeroBits(quint64(value)));
+}
+}
+
+void LatencyHistogram::record(std::uint64_t value) {
+    buckets[bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+    total.fetch_add(1, std::memory_order_relaxed);
+    sum.fetch_add(value, std::memory_order_relaxed);
+
+    std::uint64_t current = smallest.load(std::memory_order_relaxed);
+    while (value < current &&
+           !smallest.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+
+    current = largest.load(std::memory_order_relaxed);
+    while (value > current &&
+           !largest.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+}
+
+void LatencyHistogram::reset() {
+    for (auto &bucket : buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    total.store(0, std::memory_order_relaxed);
+    sum.store(0, std::memory_order_relaxed);
+    smallest.store(UINT64_MAX, std::memory_order_relaxed);
+    largest.store(0, std::memory_order_relaxed);
+}
+
+std::uint64_t LatencyHistogram::count() const {
+    return total.load(std::memory_order_relaxed);
+}
+
+std::uint64_t LatencyHistogram::minimum() const {
+    std::uint64_t value = smallest.load(std::memory_order_relaxed);
+    return value == UINT64_MAX ? 0 : value;
+}
+
+std::uint64_t LatencyHistogram::maximum() const {
+    return largest.load(std::memory_order_relaxed);
+}
+
+double LatencyHistogram::mean() const {
+    std::uint64_t n = count();
+    return n > 0 ? double(sum.load(std::memory_order_relaxed)) / n : 0.0;
+}
+
+std::uint64_t LatencyHistogram::percentile(double percentile) const {
+    std::uint64_t n = count();
+    if (n == 0) return 0;
+
+    double clamped = std::clamp(percentile, 0.0, 100.0);
+    auto rank = std::max<std::uint64_t>(1, std::uint64_t(std::ceil(clamped / 100.0 * n)));
+
+    std::uint64_t seen = 0;
+    for (int i = 0; i < BucketCount; ++i) {
+        seen += buckets[i].load(std::memory_order_relaxed);
+        if (seen >= rank) {
+            return std::min(bucketUpperBound(i), maximum());
+        }
+    }
+    return maximum();
+}
+
+int LatencyHistogram::bucketIndex(std::uint64_t value) {
+    if (value < SubBucketCount) {
+        return int(value);
+    }
+
+    // Oberste SubBucketBits+1 Bits bestimmen Klasse und Unterklasse
+    int shift = mostSignificantBit(value) - SubBucketBits;
+    int subBucket = int(value >> shift) - SubBucketCount;
+    return (shift + 1) * SubBucketCount + subBucket;
+}
+
+std::uint64_t LatencyHistogram::bucketUpperBound(int index) {
+    if (index < SubBucketCount) {
+        return std::uint64_t(index);
+    }
+
+    int shift = index / SubBucketCount - 1;
+    std::uint64_t subBucket = std::uint64_t(index % SubBucketCount) + SubBucketCount;
+    return ((subBucket + 1) << shift) - 1;
+}
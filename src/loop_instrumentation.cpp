@@ -0,0 +1,117 @@
+#include "loop_instrumentation.h"
+#include <QDebug>
+#include <algorithm>
+
+namespace {
+PercentileSummary summarize(const LatencyHistogram &histogram) {
+    constexpr double NsPerUs = 1000.0;
+
+    PercentileSummary summary;
+    summary.count = histogram.count();
+    summary.minimum = histogram.minimum() / NsPerUs;
+    summary.p50 = histogram.percentile(50.0) / NsPerUs;
+    summary.p90 = histogram.percentile(90.0) / NsPerUs;
+    summary.p99 = histogram.percentile(99.0) / NsPerUs;
+    summary.p999 = histogram.percentile(99.9) / NsPerUs;
+    summary.maximum = histogram.maximum() / NsPerUs;
+    summary.mean = histogram.mean() / NsPerUs;
+    return summary;
+}
+
+QString formatSummary(const char *label, const PercentileSummary &summary) {
+    return QString("  %1 n=%2 p50 %3 µs  p90 %4 µs  p99 %5 µs  p99.9 %6 µs  max %7 µs\n")
+        .arg(label, -10)
+        .arg(summary.count)
+        .arg(summary.p50, 0, 'f', 1)
+        .arg(summary.p90, 0, 'f', 1)
+        .arg(summary.p99, 0, 'f', 1)
+        .arg(summary.p999, 0, 'f', 1)
+        .arg(summary.maximum, 0, 'f', 1);
+}
+}
+
+LoopProbe::LoopProbe(const char *name)
+    : loopName(name)
+{
+}
+
+// Negative Werte (z.B. zu früh geweckt) zählen als 0
+void LoopProbe::recordPeriod(std::int64_t ns) {
+    periodNs.record(std::uint64_t(std::max<std::int64_t>(0, ns)));
+}
+
+void LoopProbe::recordLateness(std::int64_t ns) {
+    latenessNs.record(std::uint64_t(std::max<std::int64_t>(0, ns)));
+}
+
+void LoopProbe::recordExecution(std::int64_t ns) {
+    executionNs.record(std::uint64_t(std::max<std::int64_t>(0, ns)));
+}
+
+void LoopProbe::recordLatency(std::int64_t ns) {
+    latencyNs.record(std::uint64_t(std::max<std::int64_t>(0, ns)));
+}
+
+LoopStatistics LoopProbe::statistics() const {
+    LoopStatistics statistics;
+    statistics.period = summarize(periodNs);
+    statistics.lateness = summarize(latenessNs);
+    statistics.execution = summarize(executionNs);
+    statistics.latency = summarize(latencyNs);
+    return statistics;
+}
+
+void LoopProbe::reset() {
+    periodNs.reset();
+    latenessNs.reset();
+    executionNs.reset();
+    latencyNs.reset();
+}
+
+LoopStatisticsReporter::LoopStatisticsReporter(QObject *parent)
+    : QObject(parent)
+    , dumpTimer(new QTimer(this))
+    , resetAfterDump(false)
+{
+    connect(dumpTimer, &QTimer::timeout, this, &LoopStatisticsReporter::dump);
+}
+
+void LoopStatisticsReporter::addProbe(LoopProbe *probe) {
+    if (probe && !probes.contains(probe)) {
+        probes.append(probe);
+    }
+}
+
+void LoopStatisticsReporter::setResetAfterDump(bool reset) {
+    resetAfterDump = reset;
+}
+
+void LoopStatisticsReporter::start(int intervalMs) {
+    dumpTimer->start(std::max(100, intervalMs));
+}
+
+void LoopStatisticsReporter::stop() {
+    dumpTimer->stop();
+}
+
+QString LoopStatisticsReporter::report() const {
+    QString text;
+    for (const LoopProbe *probe : probes) {
+        LoopStatistics statistics = probe->statistics();
+        text += QString("%1:\n").arg(probe->name());
+        text += formatSummary("Periode", statistics.period);
+        text += formatSummary("Verspätung", statistics.lateness);
+        text += formatSummary("Rechenzeit", statistics.execution);
+        text += formatSummary("Latenz", statistics.latency);
+    }
+    return text;
+}
+
+void LoopStatisticsReporter::dump() {
+    qDebug().noquote() << report();
+    if (resetAfterDump) {
+        for (LoopProbe *probe : probes) {
+            probe->reset();
+        }
+    }
+}
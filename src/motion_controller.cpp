@@ -1,21 +1,73 @@
 #include "motion_controller.h"
+#include "gcode_encoder.h"
+#include "job_manager.h"
 #include <QDebug>
+#include <algorithm>
+
+namespace {
+// Wartezeit ohne neue Bewegung, nach der der Planer geleert wird (ms)
+constexpr int PlannerIdleFlushMs = 20;
+// Mindestabstand zwischen zwei positionChanged-Signalen (ms)
+constexpr int PositionUpdateIntervalMs = 50;
+// Jog-Bewegung, die höchstens noch in der Firmware vorausgeplant sein darf,
+// bevor das nächste Ziel gesendet wird (ms)
+constexpr qint64 JogLeadMs = 50;
+// Erneuter Versuch, wenn der Sendekanal noch belegt ist (ms)
+constexpr int JogRetryMs = 5;
+}
 
 MotionController::MotionController(QObject *parent)
     : QObject(parent)
-    , serialPort(new QSerialPort(this))
+    , ioThread(new QThread(this))
+    , gcodeSender(new GCodeSender)
+    , isConnected(false)
+    , portName("COM3") // Anpassen an tatsächlichen Port
+    , baudRate(QSerialPort::Baud115200)
+    , plannerFlushTimer(new QTimer(this))
+    , positionUpdateTimer(new QTimer(this))
+    , positionReportMode(PositionReportMode::MarlinAutoReport)
+    , positionReportIntervalMs(PositionUpdateIntervalMs)
+    , lastReportSequence(0)
+    , commandedPositionChanged(false)
+    , jogTimer(new QTimer(this))
+    , pendingJogTarget{0.0, 0.0, 0.0}
+    , hasPendingJog(false)
+    , pendingConveyorSpeed(-1)
+    , motionBusyUntilNs(0)
+    , feedrate(50.0)
     , currentX(0)
     , currentY(0)
     , currentZ(0)
     , currentConveyorSpeed(0)
+    , currentConveyorPosition(0.0)
+    , conveyorCoordinated(false)
     , isInitialized(false)
 {
+    // Serielle Kommunikation auf eigenem Thread, unabhängig von der GUI-Ereignisschleife
+    ioThread->setObjectName("SerialIO");
+    gcodeSender->moveToThread(ioThread);
+    connect(ioThread, &QThread::finished, gcodeSender, &QObject::deleteLater);
+    connect(gcodeSender, &GCodeSender::errorOccurred, this, &MotionController::errorOccurred);
+    connect(gcodeSender, &GCodeSender::responsesAvailable, this, &MotionController::processResponses);
+    ioThread->start(QThread::TimeCriticalPriority);
+
+    plannerFlushTimer->setSingleShot(true);
+    plannerFlushTimer->setInterval(PlannerIdleFlushMs);
+    connect(plannerFlushTimer, &QTimer::timeout, this, &MotionController::flushPlanner);
+
+    // Positionsmeldungen an die GUI mit begrenzter Rate
+    positionUpdateTimer->setSingleShot(true);
+    positionUpdateTimer->setInterval(PositionUpdateIntervalMs);
+    connect(positionUpdateTimer, &QTimer::timeout, this, &MotionController::publishPosition);
+
+    jogTimer->setSingleShot(true);
+    connect(jogTimer, &QTimer::timeout, this, &MotionController::dispatchJog);
+    motionClock.start();
 }
 
 MotionController::~MotionController() {
-    if (serialPort->isOpen()) {
-        serialPort->close();
-    }
+    ioThread->quit();
+    ioThread->wait();
 }
 
 bool MotionController::initialize() {
@@ -31,88 +83,561 @@ bool MotionController::initialize() {
     sendGCode("G90"); // Absolute Positionierung
     sendGCode("G28"); // Referenzfahrt aller Achsen
     
+    // Beschleunigung und Eckenabweichung der Firmware an den Planer angleichen
+    const PlannerSettings &settings = planner.settings();
+    GCodeCommand command;
+    if (checkEncoded(GCodeLineWriter(command).literal("M204")
+                         .word<'S'>(std::llround(settings.acceleration)).finish())) {
+        submitCommand(command);
+    }
+    if (checkEncoded(GCodeLineWriter(command).literal("M205")
+                         .word<'J', 3>(settings.junctionDeviation).finish())) {
+        submitCommand(command);
+    }
+    planner.reset(axisTarget(0.0, 0.0, 0.0));
+    
+    // Ist-Position von der Firmware melden lassen; positionChanged folgt dann
+    // den gemeldeten statt den befohlenen Koordinaten
+    if (positionReportMode != PositionReportMode::None) {
+        gcodeSender->setPositionReporting(positionReportMode, positionReportIntervalMs);
+        positionUpdateTimer->setSingleShot(false);
+        positionUpdateTimer->start();
+    }
+    
     isInitialized = true;
     return true;
 }
 
+void MotionController::setPortName(const QString &name) {
+    portName = name;
+}
+
+void MotionController::setBaudRate(qint32 rate) {
+    baudRate = rate;
+}
+
 bool MotionController::connectToHardware() {
-    // COM-Port-Einstellungen
-    serialPort->setPortName("COM3"); // Anpassen an tatsächlichen Port
-    serialPort->setBaudRate(QSerialPort::Baud115200);
-    serialPort->setDataBits(QSerialPort::Data8);
-    serialPort->setParity(QSerialPort::NoParity);
-    serialPort->setStopBits(QSerialPort::OneStop);
-    serialPort->setFlowControl(QSerialPort::NoFlowControl);
-    
-    if (!serialPort->open(QIODevice::ReadWrite)) {
-        qDebug() << "Fehler beim Öffnen des seriellen Ports:" << serialPort->errorString();
-        return false;
-    }
+    // Der Port muss im I/O-Thread geöffnet werden, dem er gehört
+    bool opened = false;
+    QMetaObject::invokeMethod(gcodeSender, [this]() {
+        return gcodeSender->openPort(portName, baudRate);
+    }, Qt::BlockingQueuedConnection, &opened);
     
-    return true;
+    isConnected = opened;
+    return opened;
 }
 
 void MotionController::moveToPosition(double x, double y, double z) {
     if (!isInitialized) return;
     
-    // Bewegungsbefehl generieren
-    QString command = QString("G1 X%1 Y%2 Z%3 F3000")
-        .arg(x, 0, 'f', 3)
-        .arg(y, 0, 'f', 3)
-        .arg(z, 0, 'f', 3);
+    // Bewegung an den Planer übergeben; freigegebene Segmente sofort senden
+    planner.addMove(axisTarget(x, y, z), feedrate, plannedMoves);
+    sendPlannedMoves();
+    plannerFlushTimer->start();
+    
+    setCommandedPosition(x, y, z);
+}
+
+void MotionController::moveAlongPath(const QVector<QVector3D> &path) {
+    if (!isInitialized || path.isEmpty()) return;
+    
+    // Gesamten Pfad einmal vereinfachen, planen und kodieren, dann in einem
+    // Zug übergeben
+    plannerFlushTimer->stop();
+    
+    std::vector<AxisVector> points;
+    points.reserve(path.size());
+    for (const QVector3D &point : path) {
+        points.push_back(axisTarget(point.x(), point.y(), point.z()));
+    }
+    std::vector<PathSegment> segments =
+        pathSimplifier.simplify(axisTarget(currentX, currentY, currentZ), points);
+    
+    QVector<GCodeCommand> stream;
+    stream.reserve(int(segments.size()));
+    
+    for (const PathSegment &segment : segments) {
+        if (segment.type == PathSegment::Line) {
+            planner.addMove(segment.end, feedrate, plannedMoves);
+            appendPlannedMoves(stream);
+            continue;
+        }
+        
+        // Bögen plant die Firmware selbst; davor müssen alle Geraden raus
+        planner.flush(plannedMoves);
+        appendPlannedMoves(stream);
+        appendArc(stream, segment);
+        planner.reset(segment.end);
+    }
+    planner.flush(plannedMoves);
+    appendPlannedMoves(stream);
+    
+    submitStream(stream);
+    
+    const QVector3D &end = path.last();
+    setCommandedPosition(end.x(), end.y(), end.z());
+}
+
+QVector<double> MotionController::executeSolderSequence(const QVector<SolderPoint> &points,
+                                                        const SolderSequenceSettings &settings) {
+    QVector<double> contactTimes;
+    if (!isInitialized || points.isEmpty()) return contactTimes;
+    
+    plannerFlushTimer->stop();
+    QVector<GCodeCommand> stream;
+    stream.reserve(points.size() * 6);
+    contactTimes.reserve(points.size());
+    qint64 startNs = motionClock.nsecsElapsed();
+    
+    double x = currentX;
+    double y = currentY;
+    double z = currentZ;
+    
+    for (const SolderPoint &point : points) {
+        double targetX = point.position.x();
+        double targetY = point.position.y();
+        double targetZ = point.position.z();
+        double safeZ = std::max(z, targetZ) + settings.clearanceHeight;
+        
+        // Anheben, Verfahren in sicherer Höhe und Absenken werden gemeinsam
+        // geplant, damit die Ecken ohne Stillstand durchfahren werden
+        planner.addMove(axisTarget(x, y, safeZ), settings.retractSpeed, plannedMoves);
+        planner.addMove(axisTarget(targetX, targetY, safeZ), settings.travelSpeed, plannedMoves);
+        planner.addMove(axisTarget(targetX, targetY, targetZ), settings.approachSpeed, plannedMoves);
+        
+        // Vor dem Löten muss der Kopf stehen
+        planner.flush(plannedMoves);
+        appendPlannedMoves(stream);
+        contactTimes.append(double(motionBusyUntilNs - startNs) / 1e9);
+        
+        GCodeCommand dwellCommand;
+        if (checkEncoded(GCodeEncoder::dwell(dwellCommand, point.dwellTime))) {
+            stream.append(dwellCommand);
+            motionBusyUntilNs += qint64(point.dwellTime) * 1000000;
+        }
+        
+        x = targetX;
+        y = targetY;
+        z = targetZ;
+    }
+    
+    // Abschließend in die sichere Höhe zurückziehen
+    planner.addMove(axisTarget(x, y, z + settings.clearanceHeight), settings.retractSpeed, plannedMoves);
+    planner.flush(plannedMoves);
+    appendPlannedMoves(stream);
+    
+    submitStream(stream);
+    
+    setCommandedPosition(x, y, z + settings.clearanceHeight);
+    return contactTimes;
+}
+
+QVector<double> MotionController::executeTrackedSequence(const QVector<SolderPoint> &points,
+                                                         double boardConveyorPosition,
+                                                         const SolderSequenceSettings &settings) {
+    QVector<double> contactTimes;
+    if (!isInitialized || points.isEmpty()) return contactTimes;
+    
+    plannerFlushTimer->stop();
+    QVector<GCodeCommand> stream;
+    stream.reserve(points.size() * 8);
+    contactTimes.reserve(points.size());
+    
+    // Handbetrieb des Bandes (M106) und Bandachse schließen sich aus
+    pendingConveyorSpeed = -1;
+    if (currentConveyorSpeed != 0) {
+        GCodeCommand command;
+        if (checkEncoded(GCodeEncoder::fanSpeed(command, 0))) {
+            stream.append(command);
+        }
+        currentConveyorSpeed = 0;
+        emit conveyorSpeedChanged(0);
+    }
+    // Bis der Planer die letzte mitlaufende Bewegung abgegeben hat
+    conveyorCoordinated = true;
+    
+    // Ein Teil der Bewegungen bleibt im Planer; Kontaktzeiten daher aus der
+    // Dauer der Teilbewegungen statt aus den bereits gesendeten schätzen
+    double elapsed = std::max<qint64>(0, motionBusyUntilNs - motionClock.nsecsElapsed()) / 1e9;
+    
+    const double dx = tracking.directionX;
+    const double dy = tracking.directionY;
+    const double conveyorSpeed = std::max(0.1, tracking.conveyorSpeed);
+    
+    // Kopfposition im Platinensystem (Punkte bei Bandstellung boardConveyorPosition)
+    double conveyor = currentConveyorPosition;
+    double boardX = currentX - (conveyor - boardConveyorPosition) * dx;
+    double boardY = currentY - (conveyor - boardConveyorPosition) * dy;
+    double boardZ = currentZ;
+    double machineX = currentX;
+    double machineY = currentY;
+    
+    // Bewegung im Platinensystem; das Band läuft währenddessen weiter, der
+    // Kopf folgt der Platine. Dauer aus Weg und Sollgeschwindigkeit geschätzt;
+    // da Band und Portal in einer Zeile interpoliert werden, stimmt die Lage
+    // relativ zur Platine auch dann, wenn die Firmware anders beschleunigt.
+    auto track = [&](double x, double y, double z, double speed, double minimumSeconds) {
+        double distance = std::sqrt((x - boardX) * (x - boardX) + (y - boardY) * (y - boardY)
+                                  + (z - boardZ) * (z - boardZ));
+        double seconds = std::max(distance / std::max(0.1, speed), minimumSeconds);
+        double nextConveyor = conveyor + conveyorSpeed * seconds;
+        
+        // Noch einlaufende Punkte: Band weiterfahren, bis der Punkt im
+        // Arbeitsbereich liegt; bereits ausgelaufene Punkte sind verloren
+        double along = x * dx + y * dy - boardConveyorPosition;
+        nextConveyor = std::max(nextConveyor, tracking.workspaceStart - along);
+        if (along + nextConveyor > tracking.workspaceEnd) return false;
+        seconds = std::max(seconds, (nextConveyor - conveyor) / conveyorSpeed);
+        
+        double shift = nextConveyor - boardConveyorPosition;
+        AxisVector target = {x + shift * dx, y + shift * dy, z, nextConveyor};
+        double length = std::sqrt((target[0] - machineX) * (target[0] - machineX)
+                                + (target[1] - machineY) * (target[1] - machineY)
+                                + (z - boardZ) * (z - boardZ)
+                                + (nextConveyor - conveyor) * (nextConveyor - conveyor));
+        if (seconds > 0.0 && length > 0.0) {
+            planner.addMove(target, length / seconds, plannedMoves);
+            appendPlannedMoves(stream);
+        }
+        
+        elapsed += seconds;
+        boardX = x;
+        boardY = y;
+        boardZ = z;
+        machineX = target[0];
+        machineY = target[1];
+        conveyor = nextConveyor;
+        return true;
+    };
+    
+    // Anheben gelingt immer: mit der Platine, solange die Stelle im
+    // Arbeitsbereich liegt, sonst senkrecht bei kurz stehendem Band
+    auto retract = [&](double z, double speed) {
+        if (z <= boardZ || track(boardX, boardY, z, speed, 0.0)) return;
+        
+        double seconds = (z - boardZ) / std::max(0.1, speed);
+        planner.addMove(AxisVector{machineX, machineY, z, conveyor}, speed, plannedMoves);
+        appendPlannedMoves(stream);
+        elapsed += seconds;
+        boardZ = z;
+    };
+    
+    double contactZ = boardZ;
+    for (int i = 0; i < points.size(); ++i) {
+        const SolderPoint &point = points[i];
+        double targetX = point.position.x();
+        double targetY = point.position.y();
+        double targetZ = point.position.z();
+        double safeZ = std::max(boardZ, targetZ) + settings.clearanceHeight;
+        
+        // Während der Verweilzeit fährt der Kopf mit der Platine mit, statt
+        // wie im Stillstand mit G4 zu warten
+        retract(safeZ, settings.retractSpeed);
+        bool reached = track(targetX, targetY, safeZ, settings.travelSpeed, 0.0)
+                    && track(targetX, targetY, targetZ, settings.approachSpeed, 0.0);
+        contactTimes.append(reached ? elapsed : -1.0);
+        reached = reached && track(targetX, targetY, targetZ, 1.0, point.dwellTime / 1000.0);
+        if (reached) {
+            contactZ = targetZ;
+        } else {
+            // Ausgelaufener Punkt: Spitze abheben und mit dem nächsten weitermachen
+            retract(safeZ, settings.retractSpeed);
+            emit errorOccurred(QString("Lötpunkt %1 liegt außerhalb des Arbeitsbereichs; "
+                                       "Bandgeschwindigkeit zu hoch").arg(i + 1));
+        }
+    }
+    retract(contactZ + settings.clearanceHeight, settings.retractSpeed);
+    
+    // Die letzten Bewegungen bleiben im Planer: folgt gleich die nächste
+    // Platine, wird ohne Bandhalt übergeleitet, sonst leert der Timer
+    submitStream(stream);
+    plannerFlushTimer->start();
     
-    sendGCode(command);
+    currentConveyorPosition = conveyor;
+    setCommandedPosition(machineX, machineY, boardZ);
+    return contactTimes;
+}
+
+void MotionController::setConveyorTracking(const ConveyorTrackingSettings &settings) {
+    tracking = settings;
+    double length = std::hypot(tracking.directionX, tracking.directionY);
+    if (length > 0.0) {
+        tracking.directionX /= length;
+        tracking.directionY /= length;
+    } else {
+        tracking.directionX = 1.0;
+        tracking.directionY = 0.0;
+    }
+}
+
+double MotionController::conveyorPosition() const {
+    return currentConveyorPosition;
+}
+
+void MotionController::setFeedrate(double mmPerSecond) {
+    feedrate = std::max(0.1, mmPerSecond);
+}
+
+void MotionController::setPlannerSettings(const PlannerSettings &settings) {
+    flushPlanner();
+    planner.setSettings(settings);
+}
+
+void MotionController::setPathSimplifierSettings(const PathSimplifierSettings &settings) {
+    pathSimplifier.setSettings(settings);
+}
+
+void MotionController::flushPlanner() {
+    planner.flush(plannedMoves);
+    sendPlannedMoves();
+}
+
+void MotionController::sendPlannedMoves() {
+    if (plannedMoves.empty()) return;
     
-    // Aktuelle Position aktualisieren
+    // Wiederverwendeter Puffer: im Dauerbetrieb keine Allokation pro Bewegung
+    commandStream.clear();
+    appendPlannedMoves(commandStream);
+    submitStream(commandStream);
+}
+
+void MotionController::appendPlannedMoves(QVector<GCodeCommand> &stream) {
+    // Geschätztes Bewegungsende fortschreiben (Jog-Taktung, Kontaktzeiten)
+    motionBusyUntilNs = std::max(motionBusyUntilNs, motionClock.nsecsElapsed());
+    
+    GCodeCommand command;
+    for (const PlannedMove &move : plannedMoves) {
+        motionBusyUntilNs += qint64(move.duration * 1e9);
+        // Vorschub pro Segment aus dem Geschwindigkeitsprofil (mm/min)
+        bool encoded = conveyorCoordinated
+            ? GCodeEncoder::coordinatedMove(command, move.target[0], move.target[1], move.target[2],
+                                            move.target[ConveyorAxis], move.feedrate())
+            : GCodeEncoder::linearMove(command, move.target[0], move.target[1],
+                                       move.target[2], move.feedrate());
+        if (checkEncoded(encoded)) {
+            stream.append(command);
+        }
+    }
+    plannedMoves.clear();
+    
+    // Mitlaufender Strom beendet: folgende Bewegungen wieder ohne Bandachse
+    if (conveyorCoordinated && planner.bufferedMoves() == 0) {
+        conveyorCoordinated = false;
+    }
+}
+
+void MotionController::appendArc(QVector<GCodeCommand> &stream, const PathSegment &arc) {
+    GCodeCommand command;
+    if (checkEncoded(GCodeEncoder::arcMove(command, arc.type == PathSegment::ArcClockwise,
+                                           arc.end[0], arc.end[1], arc.end[2],
+                                           arc.centerOffsetX, arc.centerOffsetY,
+                                           feedrate * 60.0))) {
+        stream.append(command);
+    }
+}
+
+void MotionController::setCommandedPosition(double x, double y, double z) {
     currentX = x;
     currentY = y;
     currentZ = z;
+    commandedPositionChanged = true;
+    
+    if (!positionUpdateTimer->isActive()) {
+        positionUpdateTimer->start();
+    }
+}
+
+AxisVector MotionController::axisTarget(double x, double y, double z) const {
+    // Nicht mitlaufende Bewegungen lassen die Bandachse stehen
+    return AxisVector{x, y, z, currentConveyorPosition};
+}
+
+void MotionController::publishPosition() {
+    // Nur neue Meldungen weitergeben; solange die Firmware noch nichts
+    // gemeldet hat, die befohlene Position anzeigen
+    MachinePosition reported = gcodeSender->machinePosition();
+    if (reported.sequence == 0) {
+        if (commandedPositionChanged) {
+            commandedPositionChanged = false;
+            emit positionChanged(currentX, currentY, currentZ);
+        }
+    } else if (reported.sequence != lastReportSequence) {
+        lastReportSequence = reported.sequence;
+        emit positionChanged(reported.x, reported.y, reported.z);
+    }
+}
+
+void MotionController::setPositionReporting(PositionReportMode mode, int intervalMs) {
+    positionReportMode = mode;
+    positionReportIntervalMs = std::max(10, intervalMs);
+    if (!isInitialized) return; // Wird in initialize() übernommen
     
-    emit positionChanged(currentX, currentY, currentZ);
+    gcodeSender->setPositionReporting(mode, positionReportIntervalMs);
+    if (mode == PositionReportMode::None) {
+        positionUpdateTimer->stop();
+        positionUpdateTimer->setSingleShot(true);
+    } else {
+        positionUpdateTimer->setSingleShot(false);
+        positionUpdateTimer->start();
+    }
+}
+
+MachinePosition MotionController::actualPosition() const {
+    return gcodeSender->machinePosition();
 }
 
 void MotionController::setConveyorSpeed(int speed) {
     if (!isInitialized) return;
+    if (conveyorCoordinated) {
+        emit errorOccurred("Bandgeschwindigkeit kann während des mitlaufenden Lötens nicht gesetzt werden");
+        return;
+    }
     
     // Geschwindigkeit in M-Code umwandeln (z.B. M106 für Lüfter/Motor)
-    QString command = QString("M106 S%1").arg(speed * 255 / 100);
-    sendGCode(command);
+    GCodeCommand command;
+    if (checkEncoded(GCodeEncoder::fanSpeed(command, speed * 255 / 100))) {
+        submitCommand(command);
+    }
     
     currentConveyorSpeed = speed;
     emit conveyorSpeedChanged(speed);
 }
 
+void MotionController::jogTo(double x, double y, double z) {
+    if (!isInitialized) return;
+    
+    pendingJogTarget = axisTarget(x, y, z);
+    hasPendingJog = true;
+    dispatchJog();
+}
+
+void MotionController::jogConveyor(int speed) {
+    if (!isInitialized) return;
+    
+    pendingConveyorSpeed = speed;
+    dispatchJog();
+}
+
+void MotionController::dispatchJog() {
+    if (!isInitialized || (!hasPendingJog && pendingConveyorSpeed < 0)) return;
+    
+    // Erst senden, wenn alle früheren Befehle von der Firmware übernommen
+    // wurden; solange bleibt nur das neueste Ziel hier stehen
+    if (queueDepth() > 0 || gcodeSender->pendingAcknowledgements() > 0) {
+        jogTimer->start(JogRetryMs);
+        return;
+    }
+    
+    if (pendingConveyorSpeed >= 0) {
+        setConveyorSpeed(pendingConveyorSpeed);
+        pendingConveyorSpeed = -1;
+    }
+    if (!hasPendingJog) return;
+    
+    // Nicht mehr Bewegung vorausschicken, als die Firmware in JogLeadMs
+    // abarbeitet; sonst läuft die Maschine dem Bediener hinterher
+    qint64 waitNs = motionBusyUntilNs - motionClock.nsecsElapsed() - JogLeadMs * 1000000;
+    if (waitNs > 0) {
+        jogTimer->start(int(std::max<qint64>(1, waitNs / 1000000)));
+        return;
+    }
+    
+    // Einzelbewegung mit Halt am Ziel; das nächste Ziel ist noch unbekannt
+    plannerFlushTimer->stop();
+    planner.flush(plannedMoves);
+    planner.addMove(pendingJogTarget, feedrate, plannedMoves);
+    planner.flush(plannedMoves);
+    sendPlannedMoves();
+    
+    hasPendingJog = false;
+    setCommandedPosition(pendingJogTarget[0], pendingJogTarget[1], pendingJogTarget[2]);
+}
+
 void MotionController::emergencyStop() {
     if (!isInitialized) return;
     
-    // Sofort-Stopp-Befehl senden
-    sendGCode("M112"); // Emergency Stop
+    // Wartende Bewegungen verwerfen und Sofort-Stopp-Befehl vorbei an der
+    // Warteschlange senden
+    plannerFlushTimer->stop();
+    jogTimer->stop();
+    hasPendingJog = false;
+    pendingConveyorSpeed = -1;
+    planner.reset(axisTarget(currentX, currentY, currentZ));
+    conveyorCoordinated = false;
+    commandBacklog.clear();
     
-    // Alle Motoren deaktivieren
-    sendGCode("M18");
+    // Not-Aus (M112) und Abschalten der Motoren (M18) gehen über den
+    // Prioritätskanal des I/O-Threads an allen wartenden Befehlen vorbei
+    gcodeSender->requestEmergencyStop();
     
     isInitialized = false;
 }
 
-void MotionController::sendGCode(const QString &command) {
-    if (!serialPort->isOpen()) return;
-    
-    // Befehl mit Zeilenumbruch senden
-    QByteArray data = (command + "\n").toUtf8();
-    serialPort->write(data);
-    serialPort->flush();
+void MotionController::requestEmergencyStop() {
+    gcodeSender->requestEmergencyStop();
+}
+
+int MotionController::queueDepth() const {
+    return gcodeSender->queueDepth() + commandBacklog.size();
+}
+
+GCodeSenderStatistics MotionController::senderStatistics() const {
+    return gcodeSender->statistics();
+}
+
+void MotionController::resetSenderStatistics() {
+    gcodeSender->resetStatistics();
+}
+
+void MotionController::sendGCode(std::string_view line) {
+    GCodeCommand command;
+    if (checkEncoded(GCodeEncoder::raw(command, line))) {
+        submitCommand(command);
+    }
+}
+
+bool MotionController::checkEncoded(bool encoded) {
+    if (!encoded) {
+        emit errorOccurred("G-Code-Zeile konnte nicht kodiert werden (zu lang)");
+    }
+    return encoded;
+}
+
+void MotionController::submitStream(const QVector<GCodeCommand> &stream) {
+    if (!isConnected) return;
     
-    qDebug() << "G-Code gesendet:" << command;
+    for (const GCodeCommand &command : stream) {
+        submitCommand(command);
+    }
+}
+
+void MotionController::submitCommand(const GCodeCommand &command) {
+    if (!isConnected) return;
     
-    // Auf Antwort warten
-    if (!serialPort->waitForBytesWritten(1000)) {
-        emit errorOccurred("Timeout beim Senden des G-Code");
+    // Reihenfolge wahren: solange ein Rückstau besteht, wird hinten angestellt
+    if (commandBacklog.isEmpty() && gcodeSender->submit(command)) {
         return;
     }
+    commandBacklog.enqueue(command);
+}
+
+void MotionController::processResponses() {
+    SerialResponse response;
+    while (gcodeSender->pollResponse(response)) {
+        if (response.type == SerialResponse::Message) {
+            qDebug() << "Antwort erhalten:"
+                     << QByteArray(response.text, response.length);
+        }
+    }
+    
+    // Bestätigte Zeilen haben Platz im Ring geschaffen
+    while (!commandBacklog.isEmpty() && gcodeSender->submit(commandBacklog.head())) {
+        commandBacklog.dequeue();
+    }
     
-    // Antwort lesen (optional)
-    if (serialPort->waitForReadyRead(1000)) {
-        QByteArray responseData = serialPort->readAll();
-        qDebug() << "Antwort erhalten:" << responseData;
+    // Ein wartendes Jog-Ziel kann gesendet werden, sobald die Firmware
+    // die vorherigen Zeilen übernommen hat
+    if (hasPendingJog || pendingConveyorSpeed >= 0) {
+        dispatchJog();
     }
 }
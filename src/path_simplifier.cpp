@@ -0,0 +1,190 @@
+#include "path_simplifier.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+// Begrenzt den quadratischen Prüfaufwand beim Zusammenfassen von Geraden
+constexpr int MaxMergedPoints = 1024;
+
+double cross2d(double ax, double ay, double bx, double by) {
+    return ax * by - ay * bx;
+}
+
+double distanceToSegment(const AxisVector &p, const AxisVector &a, const AxisVector &b,
+                         double &projection) {
+    AxisVector ab{};
+    AxisVector ap{};
+    double lengthSquared = 0.0;
+    double dot = 0.0;
+    for (int axis = 0; axis < PlannerAxes; ++axis) {
+        ab[axis] = b[axis] - a[axis];
+        ap[axis] = p[axis] - a[axis];
+        lengthSquared += ab[axis] * ab[axis];
+        dot += ab[axis] * ap[axis];
+    }
+
+    projection = lengthSquared > 0.0 ? dot / lengthSquared : 0.0;
+    double distanceSquared = 0.0;
+    for (int axis = 0; axis < PlannerAxes; ++axis) {
+        double d = ap[axis] - projection * ab[axis];
+        distanceSquared += d * d;
+    }
+    return std::sqrt(distanceSquared);
+}
+}
+
+PathSimplifier::PathSimplifier(const PathSimplifierSettings &settings)
+{
+    setSettings(settings);
+}
+
+void PathSimplifier::setSettings(const PathSimplifierSettings &settings) {
+    config = settings;
+    config.minArcPoints = std::max(3, config.minArcPoints);
+    config.maxArcPoints = std::max(config.minArcPoints, config.maxArcPoints);
+}
+
+const PathSimplifierSettings &PathSimplifier::settings() const {
+    return config;
+}
+
+std::vector<PathSegment> PathSimplifier::simplify(const AxisVector &start,
+                                                  const std::vector<AxisVector> &points) const {
+    std::vector<AxisVector> path;
+    path.reserve(points.size() + 1);
+    path.push_back(start);
+    path.insert(path.end(), points.begin(), points.end());
+
+    std::vector<PathSegment> segments;
+    int last = int(path.size()) - 1;
+    int index = 0;
+
+    while (index < last) {
+        if (config.fitArcs) {
+            PathSegment arc;
+            int arcEnd = longestArc(path, index, arc);
+            if (arcEnd > index) {
+                segments.push_back(arc);
+                index = arcEnd;
+                continue;
+            }
+        }
+
+        int lineEnd = config.mergeCollinear ? longestLine(path, index) : index + 1;
+        PathSegment line{PathSegment::Line, path[lineEnd], 0.0, 0.0, lineEnd - index};
+        segments.push_back(line);
+        index = lineEnd;
+    }
+
+    return segments;
+}
+
+int PathSimplifier::longestLine(const std::vector<AxisVector> &path, int first) const {
+    int end = first + 1;
+    int limit = std::min(int(path.size()) - 1, first + MaxMergedPoints);
+
+    // Gerade verlängern, solange alle Zwischenpunkte in der Toleranz liegen und
+    // in Fahrtrichtung aufeinander folgen (keine Richtungsumkehr)
+    for (int candidate = end + 1; candidate <= limit; ++candidate) {
+        bool collinear = true;
+        double previousProjection = 0.0;
+        for (int k = first + 1; k < candidate; ++k) {
+            double projection;
+            double distance = distanceToSegment(path[k], path[first], path[candidate], projection);
+            if (distance > config.tolerance || projection < previousProjection || projection > 1.0) {
+                collinear = false;
+                break;
+            }
+            previousProjection = projection;
+        }
+        if (!collinear) break;
+        end = candidate;
+    }
+
+    return end;
+}
+
+int PathSimplifier::longestArc(const std::vector<AxisVector> &path, int first, PathSegment &arc) const {
+    int best = -1;
+    int limit = std::min(int(path.size()) - 1, first + config.maxArcPoints - 1);
+
+    for (int last = first + 1; last <= limit; ++last) {
+        // Bögen nur in der XY-Ebene mit konstanter Höhe und stehendem Förderband
+        bool planar = true;
+        for (int axis = 2; axis < PlannerAxes; ++axis) {
+            planar = planar && std::abs(path[last][axis] - path[first][axis]) <= config.tolerance;
+        }
+        if (!planar) break;
+        if (last - first + 1 < config.minArcPoints) continue;
+
+        const AxisVector &middle = path[(first + last) / 2];
+        Circle circle;
+        if (!fitCircle(path[first], middle, path[last], circle)) break;
+        if (circle.radius < config.minArcRadius || circle.radius > config.maxArcRadius) break;
+
+        double turn = cross2d(middle[0] - path[first][0], middle[1] - path[first][1],
+                              path[last][0] - middle[0], path[last][1] - middle[1]);
+        bool clockwise = turn < 0.0;
+        if (!arcMatches(path, first, last, circle, clockwise)) break;
+
+        best = last;
+        arc.type = clockwise ? PathSegment::ArcClockwise : PathSegment::ArcCounterClockwise;
+        arc.end = path[last];
+        arc.centerOffsetX = circle.centerX - path[first][0];
+        arc.centerOffsetY = circle.centerY - path[first][1];
+        arc.sourcePoints = last - first;
+    }
+
+    return best;
+}
+
+bool PathSimplifier::fitCircle(const AxisVector &a, const AxisVector &b, const AxisVector &c,
+                               Circle &circle) const {
+    // Umkreis des Dreiecks a, b, c in der XY-Ebene
+    double bx = b[0] - a[0];
+    double by = b[1] - a[1];
+    double cx = c[0] - a[0];
+    double cy = c[1] - a[1];
+    double d = 2.0 * cross2d(bx, by, cx, cy);
+    if (std::abs(d) < 1e-12) return false; // Kollinear
+
+    double b2 = bx * bx + by * by;
+    double c2 = cx * cx + cy * cy;
+    double ux = (cy * b2 - by * c2) / d;
+    double uy = (bx * c2 - cx * b2) / d;
+
+    circle.centerX = a[0] + ux;
+    circle.centerY = a[1] + uy;
+    circle.radius = std::sqrt(ux * ux + uy * uy);
+    return true;
+}
+
+bool PathSimplifier::arcMatches(const std::vector<AxisVector> &path, int first, int last,
+                                const Circle &circle, bool clockwise) const {
+    double sweep = 0.0;
+
+    for (int k = first; k <= last; ++k) {
+        double dx = path[k][0] - circle.centerX;
+        double dy = path[k][1] - circle.centerY;
+        if (std::abs(std::sqrt(dx * dx + dy * dy) - circle.radius) > config.tolerance) {
+            return false;
+        }
+        if (k == last) break;
+
+        // Alle Teilsegmente müssen im gleichen Drehsinn verlaufen ...
+        double nx = path[k + 1][0] - circle.centerX;
+        double ny = path[k + 1][1] - circle.centerY;
+        double step = std::atan2(cross2d(dx, dy, nx, ny), dx * nx + dy * ny);
+        if ((step < 0.0) != clockwise) return false;
+        sweep += std::abs(step);
+
+        // ... und die Bogenhöhe über jeder Sehne muss in der Toleranz liegen
+        double halfChord = circle.radius * std::sin(std::abs(step) / 2.0);
+        double sagitta = circle.radius - std::sqrt(std::max(0.0, circle.radius * circle.radius
+                                                                 - halfChord * halfChord));
+        if (sagitta > config.tolerance) return false;
+    }
+
+    // Vollkreise sind bei G2/G3 mit gleichem Start- und Endpunkt mehrdeutig
+    return sweep < 1.9 * M_PI;
+}
@@ -0,0 +1,157 @@
+#include "pid_autotuner.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+constexpr double Pi = 3.14159265358979323846;
+// Grundleistung darf nicht an die Stellgrenzen laufen, sonst wird das Relais einseitig
+constexpr double MinimumBias = 5.0;
+constexpr double MaximumBias = 95.0;
+// Kürzeste Totzeit, mit der noch Verstärkungen berechnet werden (s)
+constexpr double MinimumDeadTime = 0.01;
+}
+
+void RelayAutotuner::start(double target, double ambientTemperature, const AutotuneSettings &tuneSettings) {
+    settings = tuneSettings;
+    settings.cycles = std::max(1, settings.cycles);
+    tuning = AutotuneResult();
+    setpoint = target;
+    ambient = ambientTemperature;
+    bias = 50.0;
+    amplitude = std::clamp(settings.relayAmplitude, 1.0, 50.0);
+    heating = true;
+    elapsed = 0.0;
+    lastSwitchUp = -1.0;
+    lastSwitchDown = 0.0;
+    highTime = 0.0;
+    lowTime = 0.0;
+    peakHigh = target;
+    peakLow = target;
+    completedCycles = 0;
+    sumUltimateGain = 0.0;
+    sumPeriod = 0.0;
+    sumBias = 0.0;
+    phase = Phase::WarmUp;
+}
+
+void RelayAutotuner::abort() {
+    if (!isRunning()) return;
+    tuning.success = false;
+    phase = Phase::Done;
+}
+
+void RelayAutotuner::reset() {
+    phase = Phase::Idle;
+}
+
+double RelayAutotuner::update(double temperature, double dt) {
+    if (!isRunning()) return 0.0;
+
+    elapsed += dt;
+    if (elapsed > settings.timeoutS) {
+        abort();
+        return 0.0;
+    }
+
+    // Mit voller Leistung bis zum Sollwert, erst dann beginnt der Grenzzyklus
+    if (phase == Phase::WarmUp) {
+        if (temperature < setpoint) return 100.0;
+        phase = Phase::Relay;
+        heating = false;
+        lastSwitchDown = elapsed;
+        peakHigh = temperature;
+        return bias - amplitude;
+    }
+
+    peakHigh = std::max(peakHigh, temperature);
+    peakLow = std::min(peakLow, temperature);
+
+    if (heating && temperature > setpoint + settings.hysteresis) {
+        heating = false;
+        lastSwitchDown = elapsed;
+        highTime = lastSwitchDown - lastSwitchUp;
+        peakHigh = temperature;
+    } else if (!heating && temperature < setpoint - settings.hysteresis) {
+        heating = true;
+        bool fullCycle = lastSwitchUp >= 0.0;
+        lastSwitchUp = elapsed;
+        lowTime = lastSwitchUp - lastSwitchDown;
+
+        if (fullCycle && highTime > 0.0 && lowTime > 0.0) {
+            // Beschreibungsfunktion des Relais mit Hysterese
+            double oscillation = (peakHigh - peakLow) / 2.0;
+            double effective = std::sqrt(std::max(oscillation * oscillation -
+                                                  settings.hysteresis * settings.hysteresis, 1e-6));
+            double ultimateGain = 4.0 * amplitude / (Pi * effective);
+            double period = highTime + lowTime;
+
+            // Die erste Schwingung ist noch vom Aufheizen geprägt
+            if (completedCycles > 0) {
+                sumUltimateGain += ultimateGain;
+                sumPeriod += period;
+                sumBias += bias;
+            }
+            ++completedCycles;
+
+            // Grundleistung so verschieben, dass beide Halbperioden gleich lang werden
+            bias += amplitude * (highTime - lowTime) / period;
+            bias = std::clamp(bias, MinimumBias, MaximumBias);
+            amplitude = std::min({amplitude, bias, 100.0 - bias});
+
+            if (completedCycles > settings.cycles) {
+                finish();
+                return 0.0;
+            }
+        }
+        peakLow = temperature;
+    }
+
+    return heating ? bias + amplitude : bias - amplitude;
+}
+
+void RelayAutotuner::finish() {
+    int evaluated = completedCycles - 1;
+    tuning.ultimateGain = sumUltimateGain / evaluated;
+    tuning.ultimatePeriod = sumPeriod / evaluated;
+    tuning.bias = sumBias / evaluated;
+
+    // Im Grenzzyklus liegt die mittlere Temperatur am Sollwert
+    double staticGain = (setpoint - ambient) / std::max(tuning.bias, 1e-3);
+    tuning.success = identify(tuning.ultimateGain, tuning.ultimatePeriod, staticGain, tuning.model);
+    if (tuning.success) {
+        tuning.gains = gainsFor(tuning.model);
+    }
+    phase = Phase::Done;
+}
+
+bool RelayAutotuner::identify(double ultimateGain, double ultimatePeriod, double staticGain,
+                              FopdtModel &model) {
+    // Betrag und Phase des FOPDT-Modells bei der kritischen Frequenz:
+    // K / sqrt(1 + (w*T)^2) = 1 / Ku  und  atan(w*T) + w*L = pi
+    double loopGain = staticGain * ultimateGain;
+    if (ultimatePeriod <= 0.0 || staticGain <= 0.0 || loopGain <= 1.0) return false;
+
+    double frequency = 2.0 * Pi / ultimatePeriod;
+    model.gain = staticGain;
+    model.timeConstant = std::sqrt(loopGain * loopGain - 1.0) / frequency;
+    model.deadTime = (Pi - std::atan(frequency * model.timeConstant)) / frequency;
+    return true;
+}
+
+PIDGains RelayAutotuner::gainsFor(const FopdtModel &model) {
+    // AMIGO-Regeln (Åström/Hägglund) für FOPDT-Strecken
+    double k = model.gain;
+    double t = model.timeConstant;
+    double l = std::max(model.deadTime, MinimumDeadTime);
+
+    double kp = (0.2 + 0.45 * t / l) / k;
+    double integralTime = l * (0.4 * l + 0.8 * t) / (l + 0.1 * t);
+    double derivativeTime = 0.5 * l * t / (0.3 * l + t);
+
+    PIDGains gains;
+    gains.kp = kp;
+    gains.ki = kp / integralTime;
+    gains.kd = kp * derivativeTime;
+    gains.derivativeFilter = std::max(derivativeTime / 10.0, 0.001);
+    return gains;
+}
@@ -7,6 +7,8 @@ SecuritySystem::SecuritySystem(QObject *parent)
     , currentSmokeLevel(0.0)
     , smokeThreshold(50.0)
     , smokeDetectionEnabled(true)
+    , clock(&monotonicClock)
+    , smokeSource(&simulatedSource)
 {
     // Timer für Umgebungsüberwachung
     QTimer *monitorTimer = new QTimer(this);
@@ -59,6 +61,11 @@ void SecuritySystem::setSmokeThreshold(double threshold) {
     smokeThreshold = threshold;
 }
 
+void SecuritySystem::setSensorSource(SensorSource *source, ControlClock *controlClock) {
+    smokeSource = source ? source : &simulatedSource;
+    clock = controlClock ? controlClock : &monotonicClock;
+}
+
 void SecuritySystem::updateObstacleMap(const QVector<QVector3D> &obstacles) {
     // Hinderniskarte aktualisieren und Kollisionsprüfung vorbereiten
     // Hier könnte ein Octree oder ähnliche Datenstruktur verwendet werden
@@ -163,15 +170,14 @@ void SecuritySystem::checkZoneBoundaries(const QVector3D &position) {
 
 void SecuritySystem::monitorEnvironment() {
     if (smokeDetectionEnabled) {
-        // Rauchsensor auslesen (simuliert)
-        currentSmokeLevel = 0.0;
-        static double trend = 0.1;
-        
-        // Zufällige Schwankungen simulieren
-        currentSmokeLevel += trend * (rand() % 100) / 100.0;
-        if (currentSmokeLevel > 100.0 || currentSmokeLevel < 0.0) {
-            trend = -trend;
+        // Rauchsensor auslesen (ohne Hardware simuliert)
+        qint64 nowNs = clock->nowNs();
+        double level;
+        if (!smokeSource->read(SensorId::Smoke, nowNs, level)) {
+            return;
         }
+        currentSmokeLevel = level;
+        emit smokeMeasured(level, nowNs);
         
         if (currentSmokeLevel > smokeThreshold) {
             emit smokeDetected(currentSmokeLevel);
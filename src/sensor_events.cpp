@@ -0,0 +1,76 @@
+#include "sensor_events.h"
+
+SimulatedSensorSource::SimulatedSensorSource(std::uint32_t seed) {
+    for (int sensor = 0; sensor < SensorCount; ++sensor) {
+        generators[sensor].seed(seed + std::uint32_t(sensor));
+    }
+}
+
+bool SimulatedSensorSource::read(SensorId sensor, std::int64_t, double &value) {
+    int index = int(sensor);
+    if (index < 0 || index >= SensorCount) return false;
+
+    switch (sensor) {
+    case SensorId::Lidar:
+        // Abstand in mm
+        value = std::uniform_real_distribution<>(40.0, 200.0)(generators[index]);
+        return true;
+    case SensorId::Magnetic:
+        value = std::uniform_real_distribution<>(0.0, 1.0)(generators[index]);
+        return true;
+    case SensorId::Smoke:
+        // Grundrauschen des Rauchsensors, weit unter jeder Alarmschwelle
+        value = std::uniform_real_distribution<>(0.0, 0.1)(generators[index]);
+        return true;
+    }
+    return false;
+}
+
+EdgeDetector::EdgeDetector(const HysteresisSettings &hysteresis)
+    : settings(hysteresis)
+    , active(false)
+    , pending(false)
+    , pendingSinceNs(0)
+{
+}
+
+void EdgeDetector::setSettings(const HysteresisSettings &hysteresis) {
+    settings = hysteresis;
+}
+
+void EdgeDetector::reset(bool state) {
+    active = state;
+    pending = false;
+    pendingSinceNs = 0;
+}
+
+bool EdgeDetector::update(double value, std::int64_t timestampNs) {
+    // Aktiv bleibt der Zustand bis zur Rückfallschwelle, inaktiv bis zur Ansprechschwelle
+    bool candidate;
+    if (active) {
+        candidate = settings.activeBelow ? value <= settings.releaseThreshold
+                                         : value >= settings.releaseThreshold;
+    } else {
+        candidate = settings.activeBelow ? value < settings.activateThreshold
+                                         : value > settings.activateThreshold;
+    }
+
+    if (candidate == active) {
+        pending = false;
+        return false;
+    }
+
+    if (!pending) {
+        pending = true;
+        pendingSinceNs = timestampNs;
+    }
+
+    std::int64_t debounceNs = active ? settings.releaseDebounceNs : settings.activateDebounceNs;
+    if (timestampNs - pendingSinceNs < debounceNs) {
+        return false;
+    }
+
+    active = candidate;
+    pending = false;
+    return true;
+}
@@ -1,27 +1,92 @@
 #include "sensor_manager.h"
 #include <QDebug>
-#include <random> // Nur für Simulationszwecke
+
+namespace {
+constexpr qint64 NsPerMs = 1000000;
+// Der LiDAR meldet Hindernisse im Millisekundenraster, der Magnetsensor
+// braucht für die Bauteilerkennung nur 20 Hz
+constexpr qint64 LidarPeriodNs = 1 * NsPerMs;
+constexpr qint64 MagneticPeriodNs = 50 * NsPerMs;
+constexpr int LidarPriority = 10;
+constexpr int MagneticPriority = 1;
+// Intervall, in dem Fristüberschreitungen an die GUI gemeldet werden (ms)
+constexpr int OverrunCheckIntervalMs = 1000;
+// Der Recorder leert den Ringpuffer lange bevor er voll läuft (ms)
+constexpr int RecordIntervalMs = 100;
+constexpr int RecordBatchSize = 256;
+
+HysteresisSettings defaultObstacleHysteresis() {
+    // Hindernis unter 50 mm (Sicherheitsabstand), frei erst wieder über 60 mm.
+    // Ansprechen nach kurzer Bestätigung, Freigabe erst nach längerer Ruhe.
+    HysteresisSettings settings;
+    settings.activateThreshold = 50.0;
+    settings.releaseThreshold = 60.0;
+    settings.activeBelow = true;
+    settings.activateDebounceNs = 20 * NsPerMs;
+    settings.releaseDebounceNs = 300 * NsPerMs;
+    return settings;
+}
+
+HysteresisSettings defaultComponentHysteresis() {
+    HysteresisSettings settings;
+    settings.activateThreshold = 0.55;
+    settings.releaseThreshold = 0.45;
+    settings.activateDebounceNs = 200 * NsPerMs;
+    settings.releaseDebounceNs = 200 * NsPerMs;
+    return settings;
+}
+}
 
 SensorManager::SensorManager(QObject *parent)
     : QObject(parent)
-    , updateTimer(new QTimer(this))
+    , clock(&monotonicClock)
+    , source(&simulatedSource)
+    , scheduler(clock)
+    , lidarTask(-1)
+    , overrunTimer(new QTimer(this))
+    , recordTimer(new QTimer(this))
     , lidarDistance(0.0)
     , magneticFieldStrength(0.0)
+    , obstacleDetector(defaultObstacleHysteresis())
+    , componentDetector(defaultComponentHysteresis())
     , obstaclePresent(false)
     , componentPresent(false)
+    , dropped(0)
+    , samplesPolled(false)
+    , recording(false)
 {
-    connect(updateTimer, &QTimer::timeout, this, &SensorManager::updateSensorReadings);
+    connect(overrunTimer, &QTimer::timeout, this, &SensorManager::checkOverruns);
+    connect(recordTimer, &QTimer::timeout, this, &SensorManager::drainToRecorder);
+
+    SensorTaskSettings lidar;
+    lidar.name = "LiDAR";
+    lidar.periodNs = LidarPeriodNs;
+    lidar.priority = LidarPriority;
+    lidarTask = scheduler.addTask(lidar, [this](std::int64_t releaseNs) { sampleLidar(releaseNs); });
+
+    SensorTaskSettings magnetic;
+    magnetic.name = "Magnetsensor";
+    magnetic.periodNs = MagneticPeriodNs;
+    magnetic.priority = MagneticPriority;
+    scheduler.addTask(magnetic, [this](std::int64_t releaseNs) { sampleMagnetic(releaseNs); });
 }
 
 SensorManager::~SensorManager() {
-    updateTimer->stop();
+    overrunTimer->stop();
+    scheduler.stop();
+    stopRecording();
 }
 
 bool SensorManager::initialize() {
     // Hier würde die tatsächliche Sensor-Initialisierung stattfinden
     // Für dieses Beispiel simulieren wir die Sensoren
     
-    updateTimer->start(100); // Alle 100ms aktualisieren
+    if (!scheduler.start()) {
+        emit sensorError("Sensorabtastung konnte nicht gestartet werden");
+        return false;
+    }
+    reportedOverruns.fill(0, scheduler.taskCount());
+    overrunTimer->start(OverrunCheckIntervalMs);
     return true;
 }
 
@@ -34,49 +99,164 @@ bool SensorManager::isComponentPresent() const {
 }
 
 double SensorManager::getLidarDistance() const {
-    return lidarDistance;
+    return lidarDistance.load(std::memory_order_relaxed);
 }
 
 double SensorManager::getMagneticFieldStrength() const {
-    return magneticFieldStrength;
+    return magneticFieldStrength.load(std::memory_order_relaxed);
+}
+
+void SensorManager::setSensorSource(SensorSource *sensorSource) {
+    if (scheduler.isRunning()) return;
+    source = sensorSource ? sensorSource : &simulatedSource;
+}
+
+void SensorManager::setClock(ControlClock *controlClock) {
+    if (scheduler.isRunning()) return;
+    clock = controlClock ? controlClock : &monotonicClock;
+    scheduler.setClock(clock);
+}
+
+void SensorManager::setObstacleHysteresis(const HysteresisSettings &settings) {
+    obstacleDetector.setSettings(settings);
 }
 
-void SensorManager::updateSensorReadings() {
-    // LiDAR-Sensor auslesen
-    if (readLidarSensor()) {
-        // Wenn Objekt zu nahe, Hindernis melden
-        obstaclePresent = (lidarDistance < 50.0); // 50mm Sicherheitsabstand
+void SensorManager::setComponentHysteresis(const HysteresisSettings &settings) {
+    componentDetector.setSettings(settings);
+}
+
+int SensorManager::addSensorTask(const SensorTaskSettings &settings, SensorScheduler::Task task) {
+    return scheduler.addTask(settings, std::move(task));
+}
+
+int SensorManager::pollSamples(SensorSample *samples, int maxCount) {
+    samplesPolled.store(true, std::memory_order_relaxed);
+    return popSamples(samples, maxCount);
+}
+
+int SensorManager::popSamples(SensorSample *samples, int maxCount) {
+    int count = 0;
+    while (count < maxCount && sampleRing.pop(samples[count])) {
+        ++count;
+    }
+    return count;
+}
+
+quint64 SensorManager::droppedSamples() const {
+    return dropped.load(std::memory_order_relaxed);
+}
+
+bool SensorManager::startRecording(const QString &path) {
+    stopRecording();
+    // Ältere Werte gehören nicht in die Aufzeichnung
+    SensorSample discarded;
+    while (sampleRing.pop(discarded)) {}
+
+    if (!recorder.open(path)) {
+        emit sensorError(QString("Sensoraufzeichnung %1 konnte nicht angelegt werden").arg(path));
+        return false;
+    }
+    recording.store(true, std::memory_order_relaxed);
+    recordTimer->start(RecordIntervalMs);
+    return true;
+}
+
+void SensorManager::stopRecording() {
+    if (!recorder.isOpen()) return;
+    recording.store(false, std::memory_order_relaxed);
+    recordTimer->stop();
+    drainToRecorder();
+    recorder.close();
+}
+
+bool SensorManager::isRecording() const {
+    return recorder.isOpen();
+}
+
+void SensorManager::recordSample(SensorId sensor, double value, qint64 timestampNs) {
+    recorder.append(SensorSample{timestampNs, sensor, value});
+}
+
+void SensorManager::drainToRecorder() {
+    SensorSample samples[RecordBatchSize];
+    int count;
+    while ((count = popSamples(samples, RecordBatchSize)) > 0) {
+        for (int i = 0; i < count; ++i) {
+            recorder.append(samples[i]);
+        }
+    }
+}
+
+QVector<LoopProbe *> SensorManager::loopProbes() {
+    QVector<LoopProbe *> probes;
+    for (int task = 0; task < scheduler.taskCount(); ++task) {
+        probes.append(&scheduler.taskProbe(task));
+    }
+    return probes;
+}
+
+void SensorManager::checkOverruns() {
+    for (int task = 0; task < reportedOverruns.size(); ++task) {
+        quint64 overruns = scheduler.overruns(task);
+        if (overruns > reportedOverruns[task]) {
+            reportedOverruns[task] = overruns;
+            emit samplingOverrun(scheduler.taskSettings(task).name, overruns);
+        }
+    }
+}
+
+// Zeitstempel der Messung ist die geplante Freigabe: eine Wiedergabe liefert
+// so unabhängig vom Jitter des Threads dieselben Werte und Flanken
+void SensorManager::sampleLidar(std::int64_t releaseNs) {
+    if (!readLidarSensor(releaseNs)) return;
+
+    double distance = lidarDistance.load(std::memory_order_relaxed);
+    publishSample(SensorId::Lidar, distance, releaseNs);
+    // Wenn Objekt zu nahe, Hindernis melden; nur beim Zustandswechsel
+    if (obstacleDetector.update(distance, releaseNs)) {
+        obstaclePresent = obstacleDetector.state();
         emit obstacleDetected(obstaclePresent);
+        // Von der geplanten Abtastung bis die Meldung unterwegs ist
+        scheduler.taskProbe(lidarTask).recordLatency(clock->nowNs() - releaseNs);
     }
-    
-    // Magnetsensor auslesen
-    if (readMagneticSensor()) {
-        // Wenn Magnetfeld stark genug, Bauteil erkannt
-        componentPresent = (magneticFieldStrength > 0.5);
+}
+
+void SensorManager::sampleMagnetic(std::int64_t releaseNs) {
+    if (!readMagneticSensor(releaseNs)) return;
+
+    double strength = magneticFieldStrength.load(std::memory_order_relaxed);
+    publishSample(SensorId::Magnetic, strength, releaseNs);
+    // Wenn Magnetfeld stark genug, Bauteil erkannt
+    if (componentDetector.update(strength, releaseNs)) {
+        componentPresent = componentDetector.state();
         emit componentDetected(componentPresent);
     }
 }
 
-bool SensorManager::readLidarSensor() {
-    // Hier würde der tatsächliche LiDAR-Sensor ausgelesen werden
-    // Für dieses Beispiel simulieren wir Messwerte
-    
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
-    static std::uniform_real_distribution<> dis(40.0, 200.0);
-    
-    lidarDistance = dis(gen);
+void SensorManager::publishSample(SensorId sensor, double value, qint64 timestampNs) {
+    // Ohne Abnehmer liefe der Ring nach wenigen Sekunden voll und jeder
+    // weitere Wert zählte als verworfen
+    if (!samplesPolled.load(std::memory_order_relaxed) && !recording.load(std::memory_order_relaxed)) {
+        return;
+    }
+    SensorSample sample{timestampNs, sensor, value};
+    if (!sampleRing.push(sample)) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+bool SensorManager::readLidarSensor(qint64 nowNs) {
+    // Hier würde der tatsächliche LiDAR-Sensor ausgelesen werden, als
+    // eigene SensorSource; ohne Hardware liefert die Simulation Messwerte
+    double distance;
+    if (!source->read(SensorId::Lidar, nowNs, distance)) return false;
+    lidarDistance.store(distance, std::memory_order_relaxed);
     return true;
 }
 
-bool SensorManager::readMagneticSensor() {
-    // Hier würde der tatsächliche Magnetsensor ausgelesen werden
-    // Für dieses Beispiel simulieren wir Messwerte
-    
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
-    static std::uniform_real_distribution<> dis(0.0, 1.0);
-    
-    magneticFieldStrength = dis(gen);
+bool SensorManager::readMagneticSensor(qint64 nowNs) {
+    double strength;
+    if (!source->read(SensorId::Magnetic, nowNs, strength)) return false;
+    magneticFieldStrength.store(strength, std::memory_order_relaxed);
     return true;
 }
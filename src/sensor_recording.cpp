@@ -0,0 +1,220 @@
+#include "sensor_recording.h"
+#include <QDebug>
+#include <QtEndian>
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace {
+const char FileMagic[4] = {'S', 'R', 'S', 'D'};
+constexpr quint16 FileVersion = 1;
+constexpr int HeaderSize = 8;
+// Gepufferte Bytes, bevor in die Datei geschrieben wird
+constexpr int FlushThreshold = 64 * 1024;
+
+void appendVarint(QByteArray &buffer, std::uint64_t value) {
+    while (value >= 0x80) {
+        buffer.append(char(value | 0x80));
+        value >>= 7;
+    }
+    buffer.append(char(value));
+}
+
+bool readVarint(const QByteArray &data, int &offset, std::uint64_t &value) {
+    value = 0;
+    for (int shift = 0; shift < 64 && offset < data.size(); shift += 7) {
+        auto byte = std::uint8_t(data[offset++]);
+        value |= std::uint64_t(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+std::uint64_t zigZag(std::int64_t value) {
+    return (std::uint64_t(value) << 1) ^ std::uint64_t(value >> 63);
+}
+
+std::int64_t unZigZag(std::uint64_t value) {
+    return std::int64_t(value >> 1) ^ -std::int64_t(value & 1);
+}
+}
+
+SensorRecorder::SensorRecorder()
+    : lastTimestampNs(0)
+    , samples(0)
+{
+}
+
+SensorRecorder::~SensorRecorder() {
+    close();
+}
+
+bool SensorRecorder::open(const QString &path) {
+    close();
+
+    file.setFileName(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qDebug() << "Sensoraufzeichnung konnte nicht angelegt werden:" << path;
+        return false;
+    }
+
+    buffer.clear();
+    buffer.reserve(FlushThreshold + 64);
+    buffer.append(FileMagic, sizeof(FileMagic));
+    uchar header[4];
+    qToLittleEndian<quint16>(FileVersion, header);
+    qToLittleEndian<quint16>(0, header + 2);
+    buffer.append(reinterpret_cast<const char *>(header), sizeof(header));
+
+    lastTimestampNs = 0;
+    samples = 0;
+    return true;
+}
+
+void SensorRecorder::append(const SensorSample &sample) {
+    if (!file.isOpen()) return;
+
+    // Der erste Messwert trägt die absolute Zeit als Differenz zu 0
+    appendVarint(buffer, zigZag(sample.timestampNs - lastTimestampNs));
+    lastTimestampNs = sample.timestampNs;
+    buffer.append(char(sample.sensor));
+
+    std::uint64_t bits;
+    std::memcpy(&bits, &sample.value, sizeof(bits));
+    uchar value[8];
+    qToLittleEndian<quint64>(bits, value);
+    buffer.append(reinterpret_cast<const char *>(value), sizeof(value));
+
+    ++samples;
+    if (buffer.size() >= FlushThreshold) {
+        flush();
+    }
+}
+
+void SensorRecorder::close() {
+    if (!file.isOpen()) return;
+    flush();
+    file.close();
+}
+
+void SensorRecorder::flush() {
+    if (!buffer.isEmpty() && file.write(buffer) != buffer.size()) {
+        qDebug() << "Sensoraufzeichnung unvollständig geschrieben:" << file.fileName();
+    }
+    buffer.clear();
+}
+
+SensorReplaySource::SensorReplaySource()
+    : firstNs(0)
+    , lastNs(0)
+    , startNs(NotStarted)
+{
+}
+
+bool SensorReplaySource::load(const QString &path) {
+    QFile input(path);
+    if (!input.open(QIODevice::ReadOnly)) {
+        qDebug() << "Sensoraufzeichnung konnte nicht geöffnet werden:" << path;
+        return false;
+    }
+    QByteArray data = input.readAll();
+
+    if (data.size() < HeaderSize || std::memcmp(data.constData(), FileMagic, sizeof(FileMagic)) != 0 ||
+        qFromLittleEndian<quint16>(data.constData() + 4) != FileVersion) {
+        qDebug() << "Unbekanntes Format der Sensoraufzeichnung:" << path;
+        return false;
+    }
+
+    for (Channel &channel : channels) {
+        channel = Channel();
+    }
+    firstNs = std::numeric_limits<std::int64_t>::max();
+    lastNs = std::numeric_limits<std::int64_t>::min();
+    startNs = NotStarted;
+
+    std::int64_t timestampNs = 0;
+    int offset = HeaderSize;
+    while (offset < data.size()) {
+        std::uint64_t delta;
+        if (!readVarint(data, offset, delta) || offset + 9 > data.size()) {
+            qDebug() << "Sensoraufzeichnung abgeschnitten, Rest verworfen:" << path;
+            break;
+        }
+        timestampNs += unZigZag(delta);
+        int sensor = std::uint8_t(data[offset++]);
+        std::uint64_t bits = qFromLittleEndian<quint64>(data.constData() + offset);
+        offset += 8;
+        if (sensor >= SensorCount) continue;
+
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        // Jeder Sensor hat genau einen Erzeuger, seine Zeitstempel steigen
+        channels[sensor].timestamps.push_back(timestampNs);
+        channels[sensor].values.push_back(value);
+        firstNs = std::min(firstNs, timestampNs);
+        lastNs = std::max(lastNs, timestampNs);
+    }
+
+    if (sampleCount() == 0) {
+        firstNs = lastNs = 0;
+    }
+    return true;
+}
+
+void SensorReplaySource::start(std::int64_t nowNs) {
+    startNs = nowNs;
+    for (Channel &channel : channels) {
+        channel.cursor = 0;
+    }
+}
+
+bool SensorReplaySource::read(SensorId sensor, std::int64_t nowNs, double &value) {
+    int index = int(sensor);
+    if (index < 0 || index >= SensorCount) return false;
+
+    std::int64_t start = startNs.load();
+    if (start == NotStarted) {
+        // Der erste lesende Thread legt den Beginn fest
+        startNs.compare_exchange_strong(start, nowNs);
+        start = startNs.load();
+    }
+
+    Channel &channel = channels[index];
+    std::int64_t recordedNs = firstNs + (nowNs - start);
+    while (channel.cursor < channel.timestamps.size() &&
+           channel.timestamps[channel.cursor] <= recordedNs) {
+        ++channel.cursor;
+    }
+    if (channel.cursor == 0) return false;
+
+    value = channel.values[channel.cursor - 1];
+    return true;
+}
+
+bool SensorReplaySource::finished(std::int64_t nowNs) const {
+    std::int64_t start = startNs.load();
+    return start != NotStarted && firstNs + (nowNs - start) > lastNs;
+}
+
+quint64 SensorReplaySource::sampleCount() const {
+    quint64 count = 0;
+    for (const Channel &channel : channels) {
+        count += channel.timestamps.size();
+    }
+    return count;
+}
+
+std::vector<SensorSample> SensorReplaySource::samples() const {
+    std::vector<SensorSample> all;
+    all.reserve(sampleCount());
+    for (int sensor = 0; sensor < SensorCount; ++sensor) {
+        const Channel &channel = channels[sensor];
+        for (std::size_t i = 0; i < channel.timestamps.size(); ++i) {
+            all.push_back({channel.timestamps[i], SensorId(sensor), channel.values[i]});
+        }
+    }
+    std::stable_sort(all.begin(), all.end(), [](const SensorSample &a, const SensorSample &b) {
+        return a.timestampNs < b.timestampNs;
+    });
+    return all;
+}
@@ -0,0 +1,162 @@
+#include "sensor_scheduler.h"
+#include <QDebug>
+#include <QtGlobal>
+#include <algorithm>
+#include <limits>
+
+#ifdef Q_OS_UNIX
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace {
+// Längste Schlafphase, damit stop() auch bei langsamen Aufgaben zeitnah greift
+constexpr std::int64_t MaximumSleepNs = 50000000;
+
+void raiseThreadPriority() {
+#ifdef Q_OS_UNIX
+    // Knapp unter dem Heizungsregler: dessen Zyklen sind kürzer als die
+    // Reaktionszeit, die der LiDAR braucht
+    sched_param parameter{};
+    parameter.sched_priority = sched_get_priority_min(SCHED_FIFO) + 5;
+    if (pthread_setschedparam(pthread_self(), SCHED_FIFO, &parameter) != 0) {
+        qDebug() << "Sensorthread läuft ohne Echtzeitpriorität";
+    }
+#endif
+}
+}
+
+SensorScheduler::TaskEntry::TaskEntry(const SensorTaskSettings &taskSettings, Task task)
+    : settings(taskSettings)
+    , function(std::move(task))
+    , nextReleaseNs(0)
+    , lastStartNs(-1)
+    , probe(taskSettings.name)
+    , overruns(0)
+    , skipped(0)
+{
+}
+
+SensorScheduler::SensorScheduler(ControlClock *controlClock)
+    : clock(controlClock ? controlClock : &monotonicClock)
+    , running(false)
+{
+}
+
+SensorScheduler::~SensorScheduler() {
+    stop();
+}
+
+void SensorScheduler::setClock(ControlClock *controlClock) {
+    if (running) return;
+    clock = controlClock ? controlClock : &monotonicClock;
+}
+
+int SensorScheduler::addTask(const SensorTaskSettings &settings, Task task) {
+    if (running || settings.periodNs <= 0 || !task) return -1;
+
+    SensorTaskSettings taskSettings = settings;
+    if (taskSettings.deadlineNs <= 0) {
+        taskSettings.deadlineNs = taskSettings.periodNs;
+    }
+    tasks.push_back(std::make_unique<TaskEntry>(taskSettings, std::move(task)));
+    return int(tasks.size()) - 1;
+}
+
+bool SensorScheduler::start() {
+    if (running || tasks.empty()) return false;
+
+    // Alle Aufgaben sind sofort fällig und laufen danach in ihrem eigenen Raster
+    std::int64_t nowNs = clock->nowNs();
+    for (auto &task : tasks) {
+        task->nextReleaseNs = nowNs;
+        task->lastStartNs = -1;
+    }
+
+    running = true;
+    worker = std::thread(&SensorScheduler::run, this);
+    return true;
+}
+
+void SensorScheduler::stop() {
+    running = false;
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+const SensorTaskSettings &SensorScheduler::taskSettings(int task) const {
+    return tasks[task]->settings;
+}
+
+LoopProbe &SensorScheduler::taskProbe(int task) {
+    return tasks[task]->probe;
+}
+
+std::uint64_t SensorScheduler::overruns(int task) const {
+    return tasks[task]->overruns.load(std::memory_order_relaxed);
+}
+
+std::uint64_t SensorScheduler::skippedPeriods(int task) const {
+    return tasks[task]->skipped.load(std::memory_order_relaxed);
+}
+
+void SensorScheduler::run() {
+    raiseThreadPriority();
+
+    while (running) {
+        // Alle fälligen Aufgaben abarbeiten, nach jeder neu nach Priorität wählen
+        while (TaskEntry *task = nextDueTask(clock->nowNs())) {
+            execute(*task);
+        }
+
+        std::int64_t wakeNs = std::numeric_limits<std::int64_t>::max();
+        for (const auto &task : tasks) {
+            wakeNs = std::min(wakeNs, task->nextReleaseNs);
+        }
+        clock->sleepUntil(std::min(wakeNs, clock->nowNs() + MaximumSleepNs));
+    }
+}
+
+SensorScheduler::TaskEntry *SensorScheduler::nextDueTask(std::int64_t nowNs) {
+    // Höchste Priorität zuerst, bei Gleichstand die am längsten wartende
+    TaskEntry *selected = nullptr;
+    for (const auto &task : tasks) {
+        if (task->nextReleaseNs > nowNs) continue;
+        if (!selected ||
+            task->settings.priority > selected->settings.priority ||
+            (task->settings.priority == selected->settings.priority &&
+             task->nextReleaseNs < selected->nextReleaseNs)) {
+            selected = task.get();
+        }
+    }
+    return selected;
+}
+
+void SensorScheduler::execute(TaskEntry &task) {
+    std::int64_t releaseNs = task.nextReleaseNs;
+    std::int64_t startNs = clock->nowNs();
+    if (task.lastStartNs >= 0) {
+        task.probe.recordPeriod(startNs - task.lastStartNs);
+    }
+    task.probe.recordLateness(startNs - releaseNs);
+    task.lastStartNs = startNs;
+
+    task.function(releaseNs);
+
+    std::int64_t endNs = clock->nowNs();
+    task.probe.recordExecution(endNs - startNs);
+    if (endNs > releaseNs + task.settings.deadlineNs) {
+        task.overruns.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Festes Raster: eine verspätete Freigabe läuft noch, ganz verpasste
+    // Perioden werden nicht in einer Salve nachgeholt
+    std::int64_t periodNs = task.settings.periodNs;
+    task.nextReleaseNs = releaseNs + periodNs;
+    std::int64_t missed = (endNs - task.nextReleaseNs) / periodNs;
+    if (missed > 0) {
+        task.skipped.fetch_add(std::uint64_t(missed), std::memory_order_relaxed);
+        task.nextReleaseNs += missed * periodNs;
+    }
+}
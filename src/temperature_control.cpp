@@ -1,100 +1,680 @@
 #include "temperature_control.h"
+#include "job_manager.h"
+#include <QDateTime>
 #include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QtGlobal>
+#include <algorithm>
 #include <cmath>
 
-PIDController::PIDController(double kp, double ki, double kd)
-    : kp(kp)
-    , ki(ki)
-    , kd(kd)
-    , lastError(0.0)
-    , integral(0.0)
-{
-}
+#ifdef Q_OS_UNIX
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace {
+constexpr int DefaultControlRateHz = 50;
+constexpr int MinimumControlRateHz = 1;
+constexpr int MaximumControlRateHz = 1000;
+// Rate, mit der die GUI über neue Messwerte informiert wird (ms)
+constexpr int PublishIntervalMs = 100;
+constexpr std::int64_t NanosecondsPerSecond = 1000000000;
+// Spitzentyp, solange keiner gewählt wurde
+const char *const DefaultTipType = "default";
+// Mindestabstand des Sollwerts zur Umgebung für einen Relaisversuch (K)
+constexpr double MinimumAutotuneRise = 50.0;
 
-double PIDController::calculate(double setpoint, double processVariable) {
-    double error = setpoint - processVariable;
-    integral += error;
-    double derivative = error - lastError;
-    lastError = error;
-    
-    return kp * error + ki * integral + kd * derivative;
+void raiseThreadPriority() {
+#ifdef Q_OS_UNIX
+    // Echtzeitpriorität nur, wenn der Prozess sie erhalten darf (CAP_SYS_NICE)
+    sched_param parameter{};
+    parameter.sched_priority = sched_get_priority_min(SCHED_FIFO) + 10;
+    if (pthread_setschedparam(pthread_self(), SCHED_FIFO, &parameter) != 0) {
+        qDebug() << "Regelthread läuft ohne Echtzeitpriorität";
+    }
+#endif
+}
 }
 
 TemperatureControl::TemperatureControl(QObject *parent)
     : QObject(parent)
-    , updateTimer(new QTimer(this))
-    , pidController(new PIDController(2.0, 0.5, 1.0))
-    , targetTemperature(0.0)
-    , currentTemperature(0.0)
+    , publishTimer(new QTimer(this))
+    , running(false)
     , heatingEnabled(false)
+    , powerBudget(0.0)
+    , controlRateHz(DefaultControlRateHz)
+    , demandGeneration(0)
+    , autotuneCancel(false)
+    , clock(&systemClock)
+    , channels(0)
+    , totalHeaterPower(0.0)
+    , overruns(0)
+    , loopProbe("Temperaturregelung")
+    , lastPublishedSequence(0)
+    , nextPlannedDemand(0)
+    , tuningPath(QDir::current().filePath("heater_tuning.json"))
+    , currentTipType(DefaultTipType)
+    , autotuneActive(false)
+    , nextDemand{}
+    , hasNextDemand(false)
+    , previewSetpoint(0.0)
+    , activeLoad(0.0)
 {
-    connect(updateTimer, &QTimer::timeout, this, &TemperatureControl::updateTemperature);
+    for (int c = 0; c < HeaterBank::MaxChannels; ++c) {
+        channelTargets[c] = 0.0;
+        channelEnabled[c] = true;
+        channelTemperatures[c] = 0.0;
+        channelPowers[c] = 0.0;
+        channelSetpoints[c] = 0.0;
+        channelLimited[c] = false;
+        heaters[c] = &simulatedPlants[c];
+    }
+
+    HeaterChannelSettings tip;
+    tip.ratedPower = model.heaterPower;
+    tip.priority = 1; // Die Lötspitze wird bei knappem Budget zuerst versorgt
+    tip.gains = currentGains;
+    addHeaterChannel(tip);
+
+    connect(publishTimer, &QTimer::timeout, this, &TemperatureControl::publishTemperature);
+    connect(publishTimer, &QTimer::timeout, this, &TemperatureControl::feedDemands);
 }
 
 TemperatureControl::~TemperatureControl() {
-    updateTimer->stop();
-    delete pidController;
+    publishTimer->stop();
+    running = false;
+    if (controlThread.joinable()) {
+        controlThread.join();
+    }
 }
 
 bool TemperatureControl::initialize() {
     // Hier würde die tatsächliche Hardware-Initialisierung stattfinden
-    
-    updateTimer->start(100); // Alle 100ms aktualisieren
+    if (running) return true;
+
+    // Gespeicherte Verstärkungen übernehmen, solange der Regelthread noch nicht läuft
+    PIDGains stored;
+    if (loadTuning(currentTipType, stored)) {
+        currentGains = stored;
+        bank.setGains(TipChannel, stored);
+    }
+
+    running = true;
+    controlThread = std::thread(&TemperatureControl::controlLoop, this);
+    publishTimer->start(PublishIntervalMs);
     return true;
 }
 
 void TemperatureControl::setTargetTemperature(double temperature) {
-    targetTemperature = std::clamp(temperature, 0.0, 450.0);
-    qDebug() << "Zieltemperatur gesetzt auf:" << targetTemperature;
+    setChannelTarget(TipChannel, temperature);
+    qDebug() << "Zieltemperatur gesetzt auf:" << channelTargets[TipChannel].load();
 }
 
 double TemperatureControl::getCurrentTemperature() const {
-    return currentTemperature;
+    return state.load().temperature;
 }
 
 void TemperatureControl::enableHeating(bool enable) {
     heatingEnabled = enable;
-    if (!enable) {
-        applyHeatingPower(0.0);
-    }
-}
-
-void TemperatureControl::updateTemperature() {
-    // Aktuelle Temperatur lesen
-    double measuredTemp = readTemperatureSensor();
-    
-    if (heatingEnabled) {
-        // PID-Regelung berechnen
-        double power = pidController->calculate(targetTemperature, measuredTemp);
-        power = std::clamp(power, 0.0, 100.0);
-        
-        // Heizleistung anwenden
-        applyHeatingPower(power);
-    }
-    
-    // Temperatur aktualisieren und Signal senden
-    currentTemperature = measuredTemp;
-    emit temperatureChanged(currentTemperature);
-}
-
-void TemperatureControl::applyHeatingPower(double power) {
-    // Hier würde die tatsächliche Heizungssteuerung stattfinden
-    // Für dieses Beispiel nur Logging
-    qDebug() << "Heizleistung:" << power << "%";
-}
-
-double TemperatureControl::readTemperatureSensor() {
-    // Hier würde der tatsächliche Temperatursensor ausgelesen werden
-    // Für dieses Beispiel simulieren wir eine Temperaturänderung
-    
-    static const double heatingRate = 0.1;  // °C pro 100ms bei voller Leistung
-    static const double coolingRate = 0.05; // °C pro 100ms
-    
-    if (heatingEnabled) {
-        currentTemperature += (targetTemperature - currentTemperature) * heatingRate;
-    } else {
-        currentTemperature = std::max(25.0, currentTemperature - coolingRate);
-    }
-    
-    return currentTemperature;
+    if (enable) return;
+
+    // Sofort abschalten; der Regelthread schreibt danach nur noch 0
+    std::int64_t nowNs = clock->nowNs();
+    for (int c = 0; c < channels; ++c) {
+        applyHeatingPower(c, 0.0, nowNs);
+    }
+}
+
+void TemperatureControl::setThermalModel(const ThermalModel &thermalModel) {
+    model = thermalModel;
+    model.heatCapacity = std::max(0.01, model.heatCapacity);
+    model.heaterPower = std::max(0.1, model.heaterPower);
+
+    // Die eingebaute Simulation verteilt die Wärmekapazität wie die
+    // Standardparameter auf Patrone und Spitze
+    PlantParameters defaults;
+    double share = defaults.heaterCapacity / (defaults.heaterCapacity + defaults.tipCapacity);
+    SimulatedThermalPlant &simulatedPlant = simulatedPlants[TipChannel];
+    PlantParameters plant = simulatedPlant.parameters();
+    plant.heaterPower = model.heaterPower;
+    plant.heaterCapacity = model.heatCapacity * share;
+    plant.tipCapacity = model.heatCapacity * (1.0 - share);
+    plant.ambientLoss = model.lossCoefficient;
+    plant.ambientTemperature = model.ambientTemperature;
+    simulatedPlant.setParameters(plant);
+    simulatedPlant.reset(model.ambientTemperature);
+
+    channelSettings[TipChannel].ratedPower = model.heaterPower;
+    bank.configure(TipChannel, channelSettings[TipChannel]);
+}
+
+void TemperatureControl::setClock(ControlClock *controlClock) {
+    clock = controlClock ? controlClock : &systemClock;
+}
+
+void TemperatureControl::setHeaterInterface(HeaterInterface *heaterInterface) {
+    heaters[TipChannel] = heaterInterface ? heaterInterface : &simulatedPlants[TipChannel];
+}
+
+int TemperatureControl::addHeaterChannel(const HeaterChannelSettings &settings, HeaterInterface *heaterInterface) {
+    if (running) return -1;
+
+    int channel = bank.addChannel(settings);
+    if (channel < 0) {
+        qDebug() << "Keine freien Heizkreise mehr";
+        return -1;
+    }
+    channels = bank.channelCount();
+    channelSettings[channel] = settings;
+
+    // Die Simulation skaliert das Modell der Lötspitze auf die Nennleistung:
+    // gleiche Zeitkonstanten und gleiche Endtemperatur bei 100 %
+    if (channel != TipChannel) {
+        PlantParameters plant = simulatedPlants[TipChannel].parameters();
+        double scale = std::max(0.01, settings.ratedPower / plant.heaterPower);
+        plant.heaterPower *= scale;
+        plant.heaterCapacity *= scale;
+        plant.tipCapacity *= scale;
+        plant.heaterToTip *= scale;
+        plant.ambientLoss *= scale;
+        simulatedPlants[channel].setParameters(plant);
+        simulatedPlants[channel].reset(plant.ambientTemperature);
+    }
+    heaters[channel] = heaterInterface ? heaterInterface : &simulatedPlants[channel];
+    return channel;
+}
+
+int TemperatureControl::channelCount() const {
+    return channels;
+}
+
+HeaterChannelSettings TemperatureControl::heaterChannelSettings(int channel) const {
+    if (channel < 0 || channel >= channels) return HeaterChannelSettings();
+    return channelSettings[channel];
+}
+
+bool TemperatureControl::loadHeaterConfiguration(const QString &filename) {
+    if (running) return false;
+
+    QFile file(filename);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qDebug() << "Fehler beim Öffnen der Temperaturkonfiguration:" << file.errorString();
+        return false;
+    }
+    QJsonObject config = QJsonDocument::fromJson(file.readAll()).object();
+
+    // Fehlende Werte übernehmen die Voreinstellungen aus HeaterChannelSettings
+    QJsonObject heaterChannels = config["heaterChannels"].toObject();
+    for (auto it = heaterChannels.begin(); it != heaterChannels.end(); ++it) {
+        QJsonObject entry = it.value().toObject();
+        HeaterChannelSettings settings;
+        settings.ratedPower = entry["ratedPower"].toDouble(settings.ratedPower);
+        settings.maxPower = entry["maxPower"].toDouble(settings.maxPower);
+        settings.maxTemperature = entry["maxTemperature"].toDouble(settings.maxTemperature);
+        settings.priority = entry["priority"].toInt(settings.priority);
+
+        int channel = addHeaterChannel(settings);
+        if (channel < 0) return false;
+        namedChannels.insert(it.key(), channel);
+    }
+
+    if (config.contains("powerBudget")) {
+        setPowerBudget(config["powerBudget"].toDouble());
+    }
+    return true;
+}
+
+int TemperatureControl::heaterChannel(const QString &name) const {
+    return namedChannels.value(name, -1);
+}
+
+void TemperatureControl::setChannelTarget(int channel, double temperature) {
+    if (channel < 0 || channel >= channels) return;
+    channelTargets[channel] = std::clamp(temperature, 0.0, channelSettings[channel].maxTemperature);
+}
+
+void TemperatureControl::enableChannel(int channel, bool enable) {
+    if (channel < 0 || channel >= channels) return;
+    channelEnabled[channel] = enable;
+}
+
+HeaterChannelState TemperatureControl::channelState(int channel) const {
+    HeaterChannelState channelState;
+    if (channel < 0 || channel >= channels) return channelState;
+
+    channelState.temperature = channelTemperatures[channel].load(std::memory_order_relaxed);
+    channelState.power = channelPowers[channel].load(std::memory_order_relaxed);
+    channelState.setpoint = channelSetpoints[channel].load(std::memory_order_relaxed);
+    channelState.budgetLimited = channelLimited[channel].load(std::memory_order_relaxed);
+    return channelState;
+}
+
+void TemperatureControl::setPowerBudget(double watts) {
+    powerBudget = watts;
+}
+
+double TemperatureControl::totalPower() const {
+    return totalHeaterPower.load(std::memory_order_relaxed);
+}
+
+void TemperatureControl::setPreBoostSettings(const PreBoostSettings &settings) {
+    preBoost = settings;
+}
+
+void TemperatureControl::planSolderPoints(const QVector<SolderPoint> &points,
+                                          const QVector<double> &contactTimes) {
+    std::int64_t nowNs = clock->nowNs();
+    std::uint32_t generation = demandGeneration.load();
+
+    int count = std::min(points.size(), contactTimes.size());
+    for (int i = 0; i < count; ++i) {
+        if (contactTimes[i] < 0.0) continue;
+
+        HeatDemand demand;
+        demand.contactNs = nowNs + std::int64_t(contactTimes[i] * 1e9);
+        demand.durationS = points[i].dwellTime / 1000.0;
+        demand.temperature = points[i].temperature;
+        demand.loadPower = heatLoadFor(points[i]);
+        demand.generation = generation;
+        plannedDemands.append(demand);
+    }
+    feedDemands();
+}
+
+void TemperatureControl::clearPlannedPoints() {
+    // Bereits im Ring liegende Punkte verwirft der Regelthread anhand der Generation
+    plannedDemands.clear();
+    nextPlannedDemand = 0;
+    demandGeneration.fetch_add(1);
+}
+
+void TemperatureControl::feedDemands() {
+    // Der Ring hält nur die nächsten Punkte; der Rest folgt, sobald Platz ist
+    while (nextPlannedDemand < plannedDemands.size() &&
+           demandRing.push(plannedDemands[nextPlannedDemand])) {
+        ++nextPlannedDemand;
+    }
+    if (nextPlannedDemand == plannedDemands.size() && nextPlannedDemand > 0) {
+        plannedDemands.clear();
+        nextPlannedDemand = 0;
+    }
+}
+
+double TemperatureControl::heatLoadFor(const SolderPoint &point) const {
+    // Durchsteckbauteile ziehen über Pad und Bohrung deutlich mehr Wärme ab
+    if (point.type == "PTH") return preBoost.pthLoad;
+    if (point.type == "SMD") return preBoost.smdLoad;
+    return preBoost.defaultLoad;
+}
+
+void TemperatureControl::setTipType(const QString &type) {
+    currentTipType = type.isEmpty() ? QString(DefaultTipType) : type;
+
+    PIDGains gains;
+    if (!loadTuning(currentTipType, gains)) {
+        qDebug() << "Keine gespeicherten Reglerparameter für Spitzentyp" << currentTipType;
+    }
+    setPIDGains(gains);
+}
+
+QString TemperatureControl::tipType() const {
+    return currentTipType;
+}
+
+void TemperatureControl::setPIDGains(const PIDGains &gains) {
+    currentGains = gains;
+    if (!running) {
+        bank.setGains(TipChannel, gains);
+        return;
+    }
+    // Der Regelthread übernimmt den neuesten Eintrag zu Beginn des nächsten Zyklus
+    if (!gainsRing.push(gains)) {
+        qDebug() << "Reglerparameter konnten nicht übergeben werden";
+    }
+}
+
+PIDGains TemperatureControl::pidGains() const {
+    return currentGains;
+}
+
+bool TemperatureControl::startAutotune(const AutotuneSettings &settings) {
+    if (autotuneActive) return false;
+
+    if (!heatingEnabled) {
+        qDebug() << "Autotuning nur mit freigegebener Heizung möglich";
+        return false;
+    }
+    double target = channelTargets[TipChannel].load();
+    if (target - model.ambientTemperature < MinimumAutotuneRise) {
+        qDebug() << "Zieltemperatur für Autotuning zu niedrig:" << target;
+        return false;
+    }
+
+    autotuneCancel = false;
+    if (!autotuneRequests.push(settings)) return false;
+
+    autotuneActive = true;
+    autotuneTipType = currentTipType;
+    return true;
+}
+
+void TemperatureControl::cancelAutotune() {
+    if (autotuneActive) {
+        autotuneCancel = true;
+    }
+}
+
+bool TemperatureControl::isAutotuning() const {
+    return autotuneActive;
+}
+
+AutotuneResult TemperatureControl::lastAutotuneResult() const {
+    return lastAutotune;
+}
+
+bool TemperatureControl::loadTuning(const QString &type, PIDGains &gains) const {
+    QFile file(tuningPath);
+    if (!file.exists()) return false;
+    if (!file.open(QIODevice::ReadOnly)) {
+        qDebug() << "Fehler beim Öffnen der Reglerparameter:" << file.errorString();
+        return false;
+    }
+
+    QJsonObject tips = QJsonDocument::fromJson(file.readAll()).object();
+    if (!tips.contains(type)) return false;
+
+    QJsonObject tuning = tips[type].toObject();
+    gains.kp = tuning["kp"].toDouble(gains.kp);
+    gains.ki = tuning["ki"].toDouble(gains.ki);
+    gains.kd = tuning["kd"].toDouble(gains.kd);
+    gains.derivativeFilter = tuning["derivativeFilter"].toDouble(gains.derivativeFilter);
+    return true;
+}
+
+bool TemperatureControl::saveTuning(const QString &type, const AutotuneResult &result) const {
+    // Andere Spitzentypen in der Datei bleiben erhalten
+    QJsonObject tips;
+    QFile file(tuningPath);
+    if (file.open(QIODevice::ReadOnly)) {
+        tips = QJsonDocument::fromJson(file.readAll()).object();
+        file.close();
+    }
+
+    QJsonObject tuning;
+    tuning["kp"] = result.gains.kp;
+    tuning["ki"] = result.gains.ki;
+    tuning["kd"] = result.gains.kd;
+    tuning["derivativeFilter"] = result.gains.derivativeFilter;
+    tuning["processGain"] = result.model.gain;
+    tuning["timeConstant"] = result.model.timeConstant;
+    tuning["deadTime"] = result.model.deadTime;
+    tuning["ultimateGain"] = result.ultimateGain;
+    tuning["ultimatePeriod"] = result.ultimatePeriod;
+    tuning["tuned"] = QDateTime::currentDateTime().toString(Qt::ISODate);
+    tips[type] = tuning;
+
+    if (!file.open(QIODevice::WriteOnly)) {
+        qDebug() << "Fehler beim Speichern der Reglerparameter:" << file.errorString();
+        return false;
+    }
+    file.write(QJsonDocument(tips).toJson());
+    return true;
+}
+
+void TemperatureControl::setControlRate(int hertz) {
+    controlRateHz = std::clamp(hertz, MinimumControlRateHz, MaximumControlRateHz);
+}
+
+int TemperatureControl::controlRate() const {
+    return controlRateHz.load();
+}
+
+ThermalSnapshot TemperatureControl::snapshot() const {
+    return state.load();
+}
+
+quint64 TemperatureControl::overrunCount() const {
+    return overruns.load(std::memory_order_relaxed);
+}
+
+LoopProbe &TemperatureControl::controlLoopProbe() {
+    return loopProbe;
+}
+
+void TemperatureControl::publishTemperature() {
+    ThermalSnapshot current = state.load();
+    if (current.sequence == lastPublishedSequence) return;
+
+    lastPublishedSequence = current.sequence;
+    emit temperatureChanged(current.temperature);
+
+    AutotuneResult result;
+    if (autotuneResults.pop(result)) {
+        autotuneActive = false;
+        lastAutotune = result;
+        if (result.success) {
+            // Der Regelthread arbeitet bereits mit den neuen Verstärkungen
+            currentGains = result.gains;
+            saveTuning(autotuneTipType, result);
+        }
+        emit autotuneFinished(result.success);
+    }
+}
+
+void TemperatureControl::controlLoop() {
+    raiseThreadPriority();
+
+    std::int64_t lastCycleNs = clock->nowNs();
+    std::int64_t deadlineNs = lastCycleNs;
+
+    while (running) {
+        runCycle(deadlineNs, lastCycleNs);
+    }
+
+    std::int64_t nowNs = clock->nowNs();
+    for (int c = 0; c < channels; ++c) {
+        applyHeatingPower(c, 0.0, nowNs);
+    }
+}
+
+void TemperatureControl::runSimulation(double seconds) {
+    if (running) {
+        qDebug() << "Simulation nur ohne laufenden Regelthread möglich";
+        return;
+    }
+
+    std::int64_t lastCycleNs = clock->nowNs();
+    std::int64_t deadlineNs = lastCycleNs;
+    std::int64_t endNs = lastCycleNs + std::int64_t(seconds * NanosecondsPerSecond);
+
+    // Die Aufgaben des GUI-Threads laufen hier nach jedem Zyklus mit
+    while (deadlineNs < endNs) {
+        runCycle(deadlineNs, lastCycleNs);
+        feedDemands();
+        publishTemperature();
+    }
+}
+
+void TemperatureControl::runCycle(std::int64_t &deadlineNs, std::int64_t &lastCycleNs) {
+    std::int64_t periodNs = NanosecondsPerSecond / controlRateHz.load();
+    deadlineNs += periodNs;
+    clock->sleepUntil(deadlineNs);
+
+    // Mehr als eine Periode zu spät: als Überlauf zählen und nicht
+    // versuchen, die verpassten Zyklen nachzuholen
+    std::int64_t nowNs = clock->nowNs();
+    loopProbe.recordLateness(nowNs - deadlineNs);
+    loopProbe.recordPeriod(nowNs - lastCycleNs);
+    if (nowNs - deadlineNs > periodNs) {
+        overruns.fetch_add(1, std::memory_order_relaxed);
+        deadlineNs = nowNs;
+    }
+
+    // Der PID rechnet mit der tatsächlich vergangenen Zeit
+    double dt = double(nowNs - lastCycleNs) / NanosecondsPerSecond;
+    lastCycleNs = nowNs;
+
+    // Rechenzeit immer gegen die Systemuhr, auch in der Simulation
+    std::int64_t startNs = systemClock.nowNs();
+    updateTemperature(dt, nowNs);
+    loopProbe.recordExecution(systemClock.nowNs() - startNs);
+}
+
+void TemperatureControl::updateTemperature(double dt, std::int64_t timestampNs) {
+    std::int64_t sensorReadNs = systemClock.nowNs();
+    bool heating = heatingEnabled.load();
+    bank.setPowerBudget(powerBudget.load(std::memory_order_relaxed));
+
+    // Neueste Verstärkungen aus der GUI übernehmen
+    PIDGains gains;
+    bool gainsChanged = false;
+    while (gainsRing.pop(gains)) {
+        gainsChanged = true;
+    }
+    if (gainsChanged) {
+        bank.setGains(TipChannel, gains);
+    }
+
+    // Übrige Heizkreise: nur Sollwert und Freigabe
+    for (int c = 0; c < channels; ++c) {
+        if (c == TipChannel) continue;
+        double measured = readTemperatureSensor(c, timestampNs);
+        channelTemperatures[c].store(measured, std::memory_order_relaxed);
+        bank.setInput(c, heating && channelEnabled[c].load(std::memory_order_relaxed),
+                      channelTargets[c].load(std::memory_order_relaxed), measured);
+    }
+
+    // Lötspitze: Sollwert und Vorsteuerung aus dem Lötplan
+    double measuredTemp = readTemperatureSensor(TipChannel, timestampNs);
+    channelTemperatures[TipChannel].store(measuredTemp, std::memory_order_relaxed);
+    double setpoint = channelTargets[TipChannel].load();
+    bool tipHeating = heating && channelEnabled[TipChannel].load(std::memory_order_relaxed);
+    double feedForward = 0.0;
+    updatePreview(timestampNs, measuredTemp, setpoint, feedForward);
+
+    if (autotuner.isRunning() || !autotuneRequests.empty()) {
+        // Während des Relaisversuchs stellt der Autotuner die Leistung,
+        // der Lötplan wird nicht vorgesteuert
+        setpoint = channelTargets[TipChannel].load();
+        feedForward = 0.0;
+        double relayPower = 0.0;
+        if (updateAutotune(tipHeating, setpoint, measuredTemp, dt, relayPower)) {
+            bank.setOverride(TipChannel, relayPower);
+        }
+    }
+    if (!tipHeating) {
+        feedForward = 0.0;
+    }
+    bank.setInput(TipChannel, tipHeating, setpoint, measuredTemp, feedForward);
+
+    // Alle Kreise in einem Durchlauf rechnen und das Budget verteilen
+    bank.update(dt);
+
+    // Heizleistung anwenden und Zustand veröffentlichen
+    for (int c = 0; c < channels; ++c) {
+        applyHeatingPower(c, bank.output(c), timestampNs);
+        channelPowers[c].store(bank.output(c), std::memory_order_relaxed);
+        channelSetpoints[c].store(bank.setpoint(c), std::memory_order_relaxed);
+        channelLimited[c].store(bank.budgetLimited(c), std::memory_order_relaxed);
+    }
+    loopProbe.recordLatency(systemClock.nowNs() - sensorReadNs);
+    totalHeaterPower.store(bank.totalPower(), std::memory_order_relaxed);
+
+    ThermalSnapshot snapshot;
+    snapshot.temperature = measuredTemp;
+    snapshot.power = bank.output(TipChannel);
+    snapshot.setpoint = setpoint;
+    snapshot.feedForward = feedForward;
+    snapshot.periodUs = dt * 1e6;
+    snapshot.timestampNs = timestampNs;
+    state.store(snapshot);
+}
+
+bool TemperatureControl::updateAutotune(bool heating, double setpoint, double measuredTemp, double dt,
+                                        double &power) {
+    AutotuneSettings request;
+    if (!autotuner.isRunning() && autotuneRequests.pop(request)) {
+        autotuner.start(setpoint, model.ambientTemperature, request);
+    }
+    if (!heating || autotuneCancel.exchange(false)) {
+        autotuner.abort();
+    }
+
+    power = autotuner.update(measuredTemp, dt);
+    if (!autotuner.isFinished()) return true;
+
+    const AutotuneResult &result = autotuner.result();
+    if (result.success) {
+        // Mit der im Grenzzyklus ermittelten Beharrungsleistung als I-Anteil
+        // weiterregeln, damit der Übergang ohne Einbruch erfolgt
+        bank.setGains(TipChannel, result.gains);
+        bank.reset(TipChannel);
+        bank.setIntegral(TipChannel, result.bias);
+    }
+    autotuneResults.push(result);
+    autotuner.reset();
+    return false;
+}
+
+void TemperatureControl::updatePreview(std::int64_t nowNs, double measuredTemp,
+                                       double &setpoint, double &feedForward) {
+    activeLoad = 0.0;
+    std::uint32_t generation = demandGeneration.load(std::memory_order_acquire);
+
+    // Abgeschlossene und verworfene Punkte überspringen
+    while (true) {
+        if (!hasNextDemand && !demandRing.pop(nextDemand)) {
+            previewSetpoint = 0.0; // Plan abgearbeitet: zurück zum Grundsollwert
+            return;
+        }
+        hasNextDemand = true;
+
+        std::int64_t contactEndNs = nextDemand.contactNs + std::int64_t(nextDemand.durationS * 1e9);
+        if (nextDemand.generation == generation && nowNs <= contactEndNs) break;
+        hasNextDemand = false;
+    }
+
+    double untilContact = double(nextDemand.contactNs - nowNs) / 1e9;
+    if (untilContact <= 0.0) {
+        activeLoad = nextDemand.loadPower;
+    }
+    if (!preBoost.enabled) return;
+
+    // Sollwert so früh umstellen, wie die Spitze laut Modell für den
+    // Temperaturwechsel braucht
+    double plannedSetpoint = previewSetpoint > 0.0 ? previewSetpoint : setpoint;
+    if (nextDemand.temperature != plannedSetpoint) {
+        double lead = std::min(model.rampTime(measuredTemp, nextDemand.temperature),
+                               preBoost.maxRampLeadS);
+        if (untilContact <= lead) {
+            previewSetpoint = nextDemand.temperature;
+        }
+    }
+    if (previewSetpoint > 0.0) {
+        setpoint = previewSetpoint;
+    }
+
+    // Erwarteten Wärmeentzug kurz vor dem Aufsetzen und während des
+    // Kontakts aufschalten; der PID gleicht nur noch den Modellfehler aus
+    if (untilContact <= preBoost.feedForwardLeadS) {
+        feedForward = nextDemand.loadPower / model.heaterPower * 100.0;
+    }
+}
+
+void TemperatureControl::applyHeatingPower(int channel, double power, std::int64_t timestampNs) {
+    // Kein Logging: Ausgaben im Regelthread würden die Periode verzerren
+    std::lock_guard<std::mutex> lock(heaterWriteMutex);
+    heaters[channel]->applyPower(heatingEnabled.load() ? power : 0.0, timestampNs);
+}
+
+double TemperatureControl::readTemperatureSensor(int channel, std::int64_t timestampNs) {
+    // Ohne angeschlossene Hardware entzieht der geplante Lötpunkt der
+    // eingebauten Simulation während des Kontakts Wärme
+    if (channel == TipChannel && heaters[TipChannel] == &simulatedPlants[TipChannel]) {
+        simulatedPlants[TipChannel].setLoadPower(activeLoad);
+    }
+    return heaters[channel]->readTemperature(timestampNs);
 }
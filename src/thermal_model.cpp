@@ -0,0 +1,13 @@
+#include "thermal_model.h"
+#include <limits>
+
+double ThermalModel::rampTime(double from, double to) const {
+    double loss = lossCoefficient * (from - ambientTemperature);
+    if (to > from) {
+        double available = heaterPower - loss;
+        return available > 0.0 ? heatCapacity * (to - from) / available
+                               : std::numeric_limits<double>::max();
+    }
+    return loss > 0.0 ? heatCapacity * (from - to) / loss
+                      : std::numeric_limits<double>::max();
+}
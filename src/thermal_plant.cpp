@@ -0,0 +1,95 @@
+#include "thermal_plant.h"
+#include <algorithm>
+
+namespace {
+constexpr std::int64_t NanosecondsPerSecond = 1000000000;
+}
+
+SimulatedThermalPlant::SimulatedThermalPlant(const PlantParameters &parameters)
+    : plant(parameters)
+    , contact(false)
+    , power(0.0)
+    , loadPower(0.0)
+    , lastNs(0)
+    , started(false)
+{
+    setParameters(parameters);
+    reset(plant.ambientTemperature);
+}
+
+void SimulatedThermalPlant::setParameters(const PlantParameters &parameters) {
+    plant = parameters;
+    plant.heaterCapacity = std::max(0.01, plant.heaterCapacity);
+    plant.tipCapacity = std::max(0.01, plant.tipCapacity);
+    plant.sensorTimeConstant = std::max(0.0, plant.sensorTimeConstant);
+    plant.stepS = std::clamp(plant.stepS, 1e-5, 0.01);
+}
+
+void SimulatedThermalPlant::reset(double temperature) {
+    heater = temperature;
+    tip = temperature;
+    sensor = temperature;
+    padTemp = plant.ambientTemperature;
+    contact = false;
+    power = 0.0;
+    started = false;
+}
+
+double SimulatedThermalPlant::readTemperature(std::int64_t nowNs) {
+    advanceTo(nowNs);
+    return sensor;
+}
+
+void SimulatedThermalPlant::applyPower(double percent, std::int64_t nowNs) {
+    advanceTo(nowNs);
+    power = std::clamp(percent, 0.0, 100.0);
+}
+
+void SimulatedThermalPlant::beginContact(const PadLoad &load, std::int64_t nowNs) {
+    advanceTo(nowNs);
+    pad = load;
+    padTemp = load.initialTemperature;
+    contact = true;
+}
+
+void SimulatedThermalPlant::endContact(std::int64_t nowNs) {
+    advanceTo(nowNs);
+    contact = false;
+}
+
+void SimulatedThermalPlant::advanceTo(std::int64_t nowNs) {
+    if (!started) {
+        lastNs = nowNs;
+        started = true;
+        return;
+    }
+
+    double remaining = double(nowNs - lastNs) / NanosecondsPerSecond;
+    lastNs = std::max(lastNs, nowNs);
+
+    // Explizites Euler-Verfahren mit festem Schritt; die Zeitkonstanten des
+    // Modells liegen um Größenordnungen darüber
+    while (remaining > 0.0) {
+        double dt = std::min(remaining, plant.stepS);
+        remaining -= dt;
+
+        double heating = power / 100.0 * plant.heaterPower;
+        double toTip = plant.heaterToTip * (heater - tip);
+        double toAmbient = plant.ambientLoss * (tip - plant.ambientTemperature);
+        double toPad = 0.0;
+        if (contact) {
+            toPad = pad.contactConductance * (tip - padTemp);
+            double toBoard = pad.boardConductance * (padTemp - plant.ambientTemperature);
+            padTemp += (toPad - toBoard) * dt / std::max(0.01, pad.capacity);
+        }
+
+        heater += (heating - toTip) * dt / plant.heaterCapacity;
+        tip += (toTip - toAmbient - toPad - loadPower) * dt / plant.tipCapacity;
+
+        if (plant.sensorTimeConstant > 0.0) {
+            sensor += (tip - sensor) * dt / std::max(plant.sensorTimeConstant, dt);
+        } else {
+            sensor = tip;
+        }
+    }
+}
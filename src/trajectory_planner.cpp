@@ -0,0 +1,187 @@
+#include "trajectory_planner.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+// Segmente unterhalb dieser Länge werden verworfen (mm)
+constexpr double MinimumSegmentLength = 1e-6;
+
+double maxSpeedOverDistance(double speed, double acceleration, double distance) {
+    return std::sqrt(speed * speed + 2.0 * acceleration * distance);
+}
+}
+
+TrajectoryPlanner::TrajectoryPlanner(const PlannerSettings &settings)
+    : lastPosition{}
+    , lastUnit{}
+    , lastNominalSpeed(0.0)
+    , lastAcceleration(0.0)
+    , releasedExitSpeed(0.0)
+{
+    setSettings(settings);
+}
+
+void TrajectoryPlanner::setSettings(const PlannerSettings &settings) {
+    config = settings;
+    config.lookAhead = std::max(1, config.lookAhead);
+    config.conveyorMaxSpeed = std::max(0.1, config.conveyorMaxSpeed);
+    config.conveyorAcceleration = std::max(1.0, config.conveyorAcceleration);
+}
+
+const PlannerSettings &TrajectoryPlanner::settings() const {
+    return config;
+}
+
+void TrajectoryPlanner::reset(const AxisVector &position) {
+    blocks.clear();
+    lastPosition = position;
+    lastUnit = AxisVector{};
+    lastNominalSpeed = 0.0;
+    releasedExitSpeed = 0.0;
+}
+
+void TrajectoryPlanner::addMove(const AxisVector &target, double nominalSpeed,
+                                std::vector<PlannedMove> &output) {
+    Block block;
+    block.target = target;
+
+    double lengthSquared = 0.0;
+    for (int axis = 0; axis < PlannerAxes; ++axis) {
+        block.unit[axis] = target[axis] - lastPosition[axis];
+        lengthSquared += block.unit[axis] * block.unit[axis];
+    }
+    block.length = std::sqrt(lengthSquared);
+    if (block.length < MinimumSegmentLength) return;
+
+    for (double &component : block.unit) {
+        component /= block.length;
+    }
+
+    block.nominalSpeed = std::clamp(nominalSpeed, 0.1, config.maxSpeed);
+    block.acceleration = config.acceleration;
+
+    // Das Förderband ist träger als die Portalachsen: Geschwindigkeit und
+    // Beschleunigung entlang der Bahn so begrenzen, dass sein Anteil passt
+    double conveyorShare = std::abs(block.unit[ConveyorAxis]);
+    if (conveyorShare > 0.0) {
+        block.nominalSpeed = std::min(block.nominalSpeed, config.conveyorMaxSpeed / conveyorShare);
+        block.acceleration = std::min(block.acceleration, config.conveyorAcceleration / conveyorShare);
+    }
+
+    // Ohne Vorgänger (Stillstand) beginnt das Segment bei 0
+    if (lastNominalSpeed > 0.0) {
+        double cornerAcceleration = std::min(lastAcceleration, block.acceleration);
+        block.maxEntrySpeed = std::min({junctionSpeed(lastUnit, block.unit, cornerAcceleration),
+                                        lastNominalSpeed, block.nominalSpeed});
+    } else {
+        block.maxEntrySpeed = 0.0;
+    }
+    block.entrySpeed = blocks.empty() ? std::min(releasedExitSpeed, block.maxEntrySpeed)
+                                      : block.maxEntrySpeed;
+
+    blocks.push_back(block);
+    lastPosition = target;
+    lastUnit = block.unit;
+    lastNominalSpeed = block.nominalSpeed;
+    lastAcceleration = block.acceleration;
+
+    recalculate();
+
+    // Ältestes Segment freigeben, sobald das Vorausschaufenster voll ist
+    while (int(blocks.size()) > config.lookAhead) {
+        releaseFront(blocks[1].entrySpeed, output);
+    }
+}
+
+void TrajectoryPlanner::flush(std::vector<PlannedMove> &output) {
+    while (!blocks.empty()) {
+        double exitSpeed = blocks.size() > 1 ? blocks[1].entrySpeed : 0.0;
+        releaseFront(exitSpeed, output);
+    }
+
+    // Nach dem Leeren steht die Maschine
+    lastUnit = AxisVector{};
+    lastNominalSpeed = 0.0;
+    releasedExitSpeed = 0.0;
+}
+
+int TrajectoryPlanner::bufferedMoves() const {
+    return int(blocks.size());
+}
+
+void TrajectoryPlanner::recalculate() {
+    if (blocks.empty()) return;
+
+    // Rückwärtsdurchlauf: das letzte Segment muss zum Stillstand kommen können
+    double nextEntry = 0.0;
+    for (int i = int(blocks.size()) - 1; i > 0; --i) {
+        Block &block = blocks[i];
+        block.entrySpeed = std::min(block.maxEntrySpeed,
+                                    maxSpeedOverDistance(nextEntry, block.acceleration, block.length));
+        nextEntry = block.entrySpeed;
+    }
+
+    // Die Eintrittsgeschwindigkeit des ersten Segments ist bereits festgelegt,
+    // da das Vorgängersegment mit dieser Austrittsgeschwindigkeit gesendet wurde.
+    // Vorwärtsdurchlauf: Beschleunigungsgrenze zwischen den Segmenten einhalten
+    for (size_t i = 1; i < blocks.size(); ++i) {
+        const Block &previous = blocks[i - 1];
+        double reachable = maxSpeedOverDistance(previous.entrySpeed, previous.acceleration,
+                                                previous.length);
+        blocks[i].entrySpeed = std::min(blocks[i].entrySpeed, reachable);
+    }
+}
+
+void TrajectoryPlanner::releaseFront(double exitSpeed, std::vector<PlannedMove> &output) {
+    const Block &block = blocks.front();
+    double acceleration = block.acceleration;
+
+    PlannedMove move;
+    move.target = block.target;
+    move.length = block.length;
+    move.entrySpeed = block.entrySpeed;
+    move.exitSpeed = exitSpeed;
+
+    // Spitzengeschwindigkeit eines Dreiecksprofils, begrenzt auf die Sollgeschwindigkeit
+    double peakSquared = acceleration * block.length
+                       + 0.5 * (block.entrySpeed * block.entrySpeed + exitSpeed * exitSpeed);
+    move.cruiseSpeed = std::max({std::min(block.nominalSpeed, std::sqrt(peakSquared)),
+                                 block.entrySpeed, exitSpeed});
+
+    // Dauer aus Beschleunigungs-, Konstant- und Bremsphase
+    double accelTime = (move.cruiseSpeed - move.entrySpeed) / acceleration;
+    double decelTime = (move.cruiseSpeed - move.exitSpeed) / acceleration;
+    double accelDistance = (move.cruiseSpeed * move.cruiseSpeed - move.entrySpeed * move.entrySpeed)
+                         / (2.0 * acceleration);
+    double decelDistance = (move.cruiseSpeed * move.cruiseSpeed - move.exitSpeed * move.exitSpeed)
+                         / (2.0 * acceleration);
+    double cruiseDistance = std::max(0.0, block.length - accelDistance - decelDistance);
+    move.duration = accelTime + decelTime
+                  + (move.cruiseSpeed > 0.0 ? cruiseDistance / move.cruiseSpeed : 0.0);
+
+    output.push_back(move);
+    releasedExitSpeed = exitSpeed;
+    blocks.pop_front();
+}
+
+double TrajectoryPlanner::junctionSpeed(const AxisVector &previousUnit, const AxisVector &unit,
+                                        double acceleration) const {
+    // Junction-Deviation-Verfahren (wie Grbl/Marlin): Kreisbogen mit der
+    // zulässigen Abweichung in die Ecke legen und die Zentripetalbeschleunigung begrenzen
+    double cosTheta = 0.0;
+    for (int axis = 0; axis < PlannerAxes; ++axis) {
+        cosTheta -= previousUnit[axis] * unit[axis];
+    }
+
+    if (cosTheta > 0.999999) {
+        return 0.0; // Richtungsumkehr
+    }
+    if (cosTheta < -0.999999) {
+        return std::numeric_limits<double>::max(); // Gerade Fortsetzung
+    }
+
+    double sinThetaHalf = std::sqrt(0.5 * (1.0 - cosTheta));
+    return std::sqrt(acceleration * config.junctionDeviation * sinThetaHalf
+                     / (1.0 - sinThetaHalf));
+}
@@ -0,0 +1,122 @@
+#include "undistortion_map.h"
+#include <QDataStream>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QVector>
+
+namespace {
+constexpr quint32 FileMagic = 0x5352554d; // "SRUM"
+constexpr quint32 FileVersion = 1;
+}
+
+std::vector<double> UndistortionMap::fingerprint(const cv::Mat &cameraMatrix, const cv::Mat &distCoeffs) {
+    std::vector<double> values;
+    for (const cv::Mat &parameter : {cameraMatrix, distCoeffs}) {
+        if (parameter.empty()) continue;
+        cv::Mat converted;
+        parameter.convertTo(converted, CV_64F);
+        values.insert(values.end(), converted.begin<double>(), converted.end<double>());
+    }
+    return values;
+}
+
+bool UndistortionMap::build(const cv::Mat &cameraMatrix, const cv::Mat &distCoeffs, cv::Size size) {
+    clear();
+    if (cameraMatrix.empty() || size.area() <= 0) {
+        return false;
+    }
+
+    // Neue Kameramatrix wie cv::undistort: gleiche Brennweite und Hauptpunkt
+    cv::initUndistortRectifyMap(cameraMatrix, distCoeffs, cv::Mat(), cameraMatrix,
+                                size, CV_16SC2, map1, map2);
+    parameters = fingerprint(cameraMatrix, distCoeffs);
+    return true;
+}
+
+bool UndistortionMap::matches(const cv::Mat &cameraMatrix, const cv::Mat &distCoeffs, cv::Size frameSize) const {
+    return isValid() && size() == frameSize && parameters == fingerprint(cameraMatrix, distCoeffs);
+}
+
+bool UndistortionMap::load(const QString &path, const cv::Mat &cameraMatrix,
+                           const cv::Mat &distCoeffs, cv::Size frameSize) {
+    clear();
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream in(&file);
+    quint32 magic, version;
+    qint32 width, height;
+    QVector<double> stored;
+    in >> magic >> version >> width >> height >> stored;
+    if (in.status() != QDataStream::Ok || magic != FileMagic || version != FileVersion) {
+        qDebug() << "Entzerrungstabellen unlesbar, werden neu berechnet:" << path;
+        return false;
+    }
+
+    // Veraltete Tabellen gehören zu einer anderen Kalibrierung oder Auflösung
+    std::vector<double> expected = fingerprint(cameraMatrix, distCoeffs);
+    if (cv::Size(width, height) != frameSize ||
+        std::vector<double>(stored.begin(), stored.end()) != expected) {
+        return false;
+    }
+
+    cv::Mat first(frameSize, CV_16SC2);
+    cv::Mat second(frameSize, CV_16UC1);
+    auto firstBytes = int(first.total() * first.elemSize());
+    auto secondBytes = int(second.total() * second.elemSize());
+    if (in.readRawData(reinterpret_cast<char *>(first.data), firstBytes) != firstBytes ||
+        in.readRawData(reinterpret_cast<char *>(second.data), secondBytes) != secondBytes) {
+        qDebug() << "Entzerrungstabellen unvollständig, werden neu berechnet:" << path;
+        return false;
+    }
+
+    map1 = first;
+    map2 = second;
+    parameters = expected;
+    return true;
+}
+
+bool UndistortionMap::save(const QString &path) const {
+    if (!isValid()) {
+        return false;
+    }
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qDebug() << "Entzerrungstabellen konnten nicht gespeichert werden:" << path;
+        return false;
+    }
+
+    QDataStream out(&file);
+    out << FileMagic << FileVersion << qint32(map1.cols) << qint32(map1.rows)
+        << QVector<double>(parameters.begin(), parameters.end());
+    // Die Tabellen sind kontinuierlich angelegt und werden roh geschrieben
+    out.writeRawData(reinterpret_cast<const char *>(map1.data), int(map1.total() * map1.elemSize()));
+    out.writeRawData(reinterpret_cast<const char *>(map2.data), int(map2.total() * map2.elemSize()));
+    return out.status() == QDataStream::Ok;
+}
+
+void UndistortionMap::clear() {
+    map1.release();
+    map2.release();
+    parameters.clear();
+}
+
+void UndistortionMap::remap(const cv::Mat &input, cv::Mat &output) const {
+    cv::remap(input, output, map1, map2, cv::INTER_LINEAR, cv::BORDER_CONSTANT);
+}
+
+void UndistortionMap::remapRegion(const cv::Mat &input, const cv::Rect &region, cv::Mat &output) const {
+    cv::Rect clipped = region & cv::Rect(0, 0, map1.cols, map1.rows);
+    cv::remap(input, output, map1(clipped), map2(clipped), cv::INTER_LINEAR, cv::BORDER_CONSTANT);
+}
+
+QString UndistortionMap::pathFor(const QString &calibrationFile) {
+    QFileInfo info(calibrationFile);
+    return info.dir().filePath(info.completeBaseName() + ".remap");
+}
@@ -1,23 +1,48 @@
 #include "vision_system.h"
+#include "fused_preprocessor.h"
 #include <QDebug>
+#include <QMetaMethod>
+#include <chrono>
+#include <thread>
+
+namespace {
+// Prüfabstand auf neue Bilder, gut die Hälfte der Bildperiode bei 30 Bildern/s.
+// Ein Timer statt einer Meldung je Bild: ein Aufruf über die Ereignisschleife
+// legt jedes Mal ein Ereignis an.
+constexpr int FramePollIntervalMs = 15;
+// Puffer für das aktuelle Bild, Anzeige und Bilder in der Ereignisschleife
+constexpr int ImagePoolSize = 4;
+// Längste Wartezeit auf ein neues Bild während der Kalibrierung (ms)
+constexpr int CalibrationFrameTimeoutMs = 1000;
+}
 
 VisionSystem::VisionSystem(QObject *parent)
     : QObject(parent)
+    , frameTimer(new QTimer(this))
+    , publishedSequence(0)
+    , imagePool(ImagePoolSize)
+    , currentImageSequence(0)
     , isInitialized(false)
 {
+    frameTimer->setTimerType(Qt::PreciseTimer);
+    connect(frameTimer, &QTimer::timeout, this, &VisionSystem::publishFrame);
+}
+
+VisionSystem::~VisionSystem() {
+    // Aufnahmethread anhalten, bevor die übrigen Member abgebaut werden
+    camera.close();
 }
 
 bool VisionSystem::initialize() {
     // Kamera initialisieren (ID 0 für die erste verfügbare Kamera)
-    if (!camera.open(0)) {
+    // Standardeinstellungen: 1280x720 bei 30 Bildern/s
+    if (!camera.open(CameraSettings())) {
         emit errorOccurred("Kamera konnte nicht initialisiert werden");
         return false;
     }
 
-    // Standardeinstellungen laden
-    camera.set(cv::CAP_PROP_FRAME_WIDTH, 1280);
-    camera.set(cv::CAP_PROP_FRAME_HEIGHT, 720);
-    camera.set(cv::CAP_PROP_FPS, 30);
+    // Die Kamera liefert womöglich eine andere Auflösung als kalibriert
+    updateUndistortion();
 
     isInitialized = true;
     return true;
@@ -27,12 +52,17 @@ bool VisionSystem::startCamera() {
     if (!isInitialized) {
         return false;
     }
-    return camera.isOpened();
+    if (!camera.start()) {
+        return false;
+    }
+    frameTimer->start(FramePollIntervalMs);
+    return true;
 }
 
 bool VisionSystem::stopCamera() {
     if (camera.isOpened()) {
-        camera.release();
+        frameTimer->stop();
+        camera.close();
         return true;
     }
     return false;
@@ -40,45 +70,93 @@ bool VisionSystem::stopCamera() {
 
 void VisionSystem::setExposure(double value) {
     if (camera.isOpened()) {
-        camera.set(cv::CAP_PROP_EXPOSURE, value);
+        camera.setProperty(cv::CAP_PROP_EXPOSURE, value);
     }
 }
 
 void VisionSystem::setGain(double value) {
     if (camera.isOpened()) {
-        camera.set(cv::CAP_PROP_GAIN, value);
+        camera.setProperty(cv::CAP_PROP_GAIN, value);
     }
 }
 
+const CameraFrame &VisionSystem::latestFrame() {
+    return camera.latestFrame();
+}
+
 QImage VisionSystem::getCurrentFrame() {
-    if (!camera.isOpened()) {
+    const CameraFrame &frame = camera.latestFrame();
+    if (frame.sequence == 0) {
         return QImage();
     }
 
-    cv::Mat frame;
-    camera.read(frame);
-    
-    if (frame.empty()) {
-        return QImage();
+    if (frame.sequence == currentImageSequence) {
+        return currentImage;
     }
 
-    // OpenCV Mat zu QImage konvertieren
+    // Den Puffer des vorigen Bildes freigeben, falls niemand mehr darauf zeigt
+    currentImage = QImage();
+
+    // OpenCV Mat zu QImage konvertieren, direkt in den gemeinsamen Puffer
     cv::Mat rgb;
-    cv::cvtColor(frame, rgb, cv::COLOR_BGR2RGB);
-    return QImage(rgb.data, rgb.cols, rgb.rows, rgb.step, QImage::Format_RGB888).copy();
+    bool pooled = imagePool.acquire(frame.image.size(), rgb, currentImage);
+    cv::cvtColor(frame.image, rgb, cv::COLOR_BGR2RGB);
+    if (!pooled) {
+        // Alle Puffer noch bei Empfängern: ausnahmsweise eigener Speicher
+        currentImage = QImage(rgb.data, rgb.cols, rgb.rows, rgb.step, QImage::Format_RGB888).copy();
+    }
+    currentImageSequence = frame.sequence;
+    return currentImage;
 }
 
 cv::Mat VisionSystem::getProcessedFrame() {
-    cv::Mat frame;
-    camera.read(frame);
-    return preprocessImage(frame);
+    const CameraFrame &frame = camera.latestFrame();
+    if (frame.sequence == 0) {
+        return cv::Mat();
+    }
+    if (undistortion.isValid() && frame.image.size() == undistortion.size()) {
+        undistortion.remap(frame.image, rectifiedFrame);
+        return preprocessImage(rectifiedFrame);
+    }
+    return preprocessImage(frame.image);
+}
+
+void VisionSystem::publishFrame() {
+    // Nur neue Bilder melden; ohne Empfänger keine Farbumwandlung
+    if (camera.capturedFrames() == publishedSequence ||
+        !isSignalConnected(QMetaMethod::fromSignal(&VisionSystem::frameReady))) {
+        return;
+    }
+
+    QImage frame = getCurrentFrame();
+    if (frame.isNull() || currentImageSequence == publishedSequence) {
+        return;
+    }
+    publishedSequence = currentImageSequence;
+    emit frameReady(frame);
+}
+
+const CameraFrame *VisionSystem::waitForNextFrame(std::uint64_t afterSequence, int timeoutMs) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    while (camera.isRunning()) {
+        const CameraFrame &frame = camera.latestFrame();
+        if (frame.sequence > afterSequence) {
+            return &frame;
+        }
+        if (std::chrono::steady_clock::now() >= deadline) {
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    return nullptr;
 }
 
 SolderJointAnalysis VisionSystem::analyzeSolderJoint(const cv::Mat &image) {
     SolderJointAnalysis analysis;
     
-    // Vorverarbeitung
-    cv::Mat processed = preprocessImage(image);
+    // Vorverarbeitung; jeder Arbeitsthread behält seinen Puffer
+    thread_local cv::Mat processed;
+    preprocessImage(image, processed);
     
     // Lötstelle segmentieren
     cv::Mat joint = segmentSolderJoint(processed);
@@ -103,6 +181,65 @@ SolderJointAnalysis VisionSystem::analyzeSolderJoint(const cv::Mat &image) {
     return analysis;
 }
 
+QVector<SolderJointAnalysis> VisionSystem::analyzeSolderJoints(const cv::Mat &frame,
+                                                              const QVector<SolderPoint> &points,
+                                                              const QTransform &boardToImage,
+                                                              int roiSize) {
+    QVector<SolderJointAnalysis> results(points.size());
+    if (frame.empty() || points.isEmpty()) {
+        return results;
+    }
+
+    // Ausschnitte vorab bestimmen; sie teilen sich den Speicher des Bildes
+    const cv::Rect bounds(0, 0, frame.cols, frame.rows);
+    const int half = std::max(1, roiSize) / 2;
+    std::vector<cv::Rect> regions(points.size());
+    for (int i = 0; i < points.size(); ++i) {
+        QPointF center = boardToImage.map(QPointF(points[i].position.x(), points[i].position.y()));
+        cv::Rect region(cvRound(center.x()) - half, cvRound(center.y()) - half, 2 * half, 2 * half);
+        regions[i] = region & bounds;
+    }
+
+    // Die Auswertefunktionen haben keinen Zustand und dürfen parallel laufen;
+    // jeder Index wird von genau einem Arbeitsthread geschrieben
+    const bool rectify = undistortion.isValid() && frame.size() == undistortion.size();
+    SolderJointAnalysis *output = results.data();
+    cv::parallel_for_(cv::Range(0, int(regions.size())), [&](const cv::Range &range) {
+        for (int i = range.start; i < range.end; ++i) {
+            // Angeschnittene Stellen am Bildrand lassen sich nicht beurteilen
+            if (regions[i].width < 2 * half || regions[i].height < 2 * half) {
+                SolderJointAnalysis &analysis = output[i];
+                analysis.isAcceptable = false;
+                analysis.diameter = 0.0;
+                analysis.height = 0.0;
+                analysis.surfaceQuality = 0.0;
+                analysis.defectType = "not_visible";
+                continue;
+            }
+            if (rectify) {
+                cv::Mat region;
+                undistortion.remapRegion(frame, regions[i], region);
+                output[i] = analyzeSolderJoint(region);
+            } else {
+                output[i] = analyzeSolderJoint(frame(regions[i]));
+            }
+        }
+    });
+
+    return results;
+}
+
+QVector<SolderJointAnalysis> VisionSystem::analyzeSolderJoints(const QVector<SolderPoint> &points,
+                                                              const QTransform &boardToImage,
+                                                              int roiSize) {
+    const CameraFrame &frame = camera.latestFrame();
+    if (frame.sequence == 0) {
+        emit errorOccurred("Kein Kamerabild für die Inspektion");
+        return QVector<SolderJointAnalysis>(points.size());
+    }
+    return analyzeSolderJoints(frame.image, points, boardToImage, roiSize);
+}
+
 QVector<cv::Point2f> VisionSystem::detectSolderPoints(const cv::Mat &image) {
     cv::Mat processed = preprocessImage(image);
     return findFeaturePoints(processed);
@@ -114,10 +251,29 @@ bool VisionSystem::calibrateCamera() {
     cv::Size patternSize(9, 6);
     float squareSize = 20.0f;
 
+    // Ohne laufende Vorschau den Aufnahmethread nur für die Kalibrierung starten
+    bool startedCapture = false;
+    if (!camera.isRunning()) {
+        if (!isInitialized || !camera.start()) {
+            emit errorOccurred("Kamera für die Kalibrierung nicht verfügbar");
+            return false;
+        }
+        startedCapture = true;
+    }
+
     // Schachbrettmuster in mehreren Ansichten aufnehmen
+    std::uint64_t lastSequence = 0;
     for (int i = 0; i < 10; ++i) {
-        cv::Mat frame;
-        camera.read(frame);
+        const CameraFrame *captured = waitForNextFrame(lastSequence, CalibrationFrameTimeoutMs);
+        if (!captured) {
+            if (startedCapture) {
+                camera.stop();
+            }
+            emit errorOccurred("Kein Kamerabild für die Kalibrierung");
+            return false;
+        }
+        lastSequence = captured->sequence;
+        const cv::Mat &frame = captured->image;
         
         std::vector<cv::Point2f> corners;
         bool found = cv::findChessboardCorners(frame, patternSize, corners);
@@ -136,15 +292,18 @@ bool VisionSystem::calibrateCamera() {
             emit calibrationProgress((i + 1) * 10);
         }
     }
+    if (startedCapture) {
+        camera.stop();
+    }
 
-    // Kalibrierung durchführen
-    cv::Mat distCoeffs;
+    // Kalibrierung durchführen; die Verzeichnung landet in distCoeffs
     std::vector<cv::Mat> rvecs, tvecs;
     double rms = cv::calibrateCamera(objectPoints, imagePoints, 
-                                   cv::Size(1280, 720), 
+                                   camera.frameSize(), 
                                    cameraMatrix, distCoeffs, 
                                    rvecs, tvecs);
 
+    updateUndistortion();
     return rms < 1.0; // RMS-Fehler sollte klein sein
 }
 
@@ -157,6 +316,9 @@ bool VisionSystem::loadCalibration(const QString &filename) {
     fs["camera_matrix"] >> cameraMatrix;
     fs["distortion_coefficients"] >> distCoeffs;
     
+    // Gespeicherte Tabellen verwenden, statt sie beim Start neu zu berechnen
+    calibrationFile = filename;
+    updateUndistortion();
     return true;
 }
 
@@ -169,24 +331,47 @@ bool VisionSystem::saveCalibration(const QString &filename) {
     fs << "camera_matrix" << cameraMatrix;
     fs << "distortion_coefficients" << distCoeffs;
     
+    calibrationFile = filename;
+    if (!updateUndistortion() && undistortion.isValid()) {
+        undistortion.save(UndistortionMap::pathFor(filename));
+    }
     return true;
 }
 
+// Berechnet die Tabellen nur, wenn Kalibrierung oder Auflösung sich geändert
+// haben und keine passenden gespeichert sind. true, wenn neu berechnet und
+// neben der Kalibrierdatei abgelegt.
+bool VisionSystem::updateUndistortion() {
+    if (cameraMatrix.empty()) {
+        undistortion.clear();
+        return false;
+    }
+
+    CameraSettings defaults;
+    cv::Size size = camera.isOpened() ? camera.frameSize() : cv::Size(defaults.width, defaults.height);
+    QString mapFile = calibrationFile.isEmpty() ? QString() : UndistortionMap::pathFor(calibrationFile);
+    if (undistortion.matches(cameraMatrix, distCoeffs, size) ||
+        (!mapFile.isEmpty() && undistortion.load(mapFile, cameraMatrix, distCoeffs, size))) {
+        return false;
+    }
+
+    if (!undistortion.build(cameraMatrix, distCoeffs, size)) {
+        return false;
+    }
+    return !mapFile.isEmpty() && undistortion.save(mapFile);
+}
+
 cv::Mat VisionSystem::preprocessImage(const cv::Mat &input) {
     cv::Mat result;
-    
-    // Rauschreduzierung
-    cv::GaussianBlur(input, result, cv::Size(5, 5), 0);
-    
-    // Kontrastverstärkung
-    cv::convertScaleAbs(result, result, 1.2, 0);
-    
-    // Graustufen
-    cv::cvtColor(result, result, cv::COLOR_BGR2GRAY);
-    
+    preprocessImage(input, result);
     return result;
 }
 
+void VisionSystem::preprocessImage(const cv::Mat &input, cv::Mat &output) {
+    // Graustufen, Kontrastverstärkung und Rauschreduzierung in einem Durchlauf
+    FusedPreprocessor::apply(input, output, FusedPreprocessor::DefaultGain);
+}
+
 cv::Mat VisionSystem::segmentSolderJoint(const cv::Mat &input) {
     cv::Mat result;
     
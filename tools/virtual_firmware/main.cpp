@@ -0,0 +1,69 @@
+#include "virtual_firmware.h"
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+
+namespace {
+volatile std::sig_atomic_t stopRequested = 0;
+
+void handleSignal(int) {
+    stopRequested = 1;
+}
+
+void printUsage(const char *program) {
+    std::printf("Aufruf: %s [--baud N] [--rx-buffer N] [--planner N] "
+                "[--line-us N] [--time-scale F]\n", program);
+}
+}
+
+int main(int argc, char *argv[]) {
+    VirtualFirmwareSettings settings;
+
+    for (int i = 1; i < argc; ++i) {
+        const char *option = argv[i];
+        if (std::strcmp(option, "--help") == 0) {
+            printUsage(argv[0]);
+            return 0;
+        }
+        if (i + 1 >= argc) {
+            printUsage(argv[0]);
+            return 1;
+        }
+
+        const char *value = argv[++i];
+        if (std::strcmp(option, "--baud") == 0) settings.baudRate = std::atoi(value);
+        else if (std::strcmp(option, "--rx-buffer") == 0) settings.rxBufferSize = std::atoi(value);
+        else if (std::strcmp(option, "--planner") == 0) settings.plannerQueueSize = std::atoi(value);
+        else if (std::strcmp(option, "--line-us") == 0) settings.lineProcessingUs = std::atoi(value);
+        else if (std::strcmp(option, "--time-scale") == 0) settings.timeScale = std::atof(value);
+        else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    VirtualFirmware firmware(settings);
+    if (!firmware.start()) {
+        return 1;
+    }
+
+    std::signal(SIGINT, handleSignal);
+    std::signal(SIGTERM, handleSignal);
+    std::printf("Virtuelle Firmware bereit an %s\n", firmware.portName().c_str());
+    std::fflush(stdout);
+
+    while (!stopRequested) {
+        usleep(100000);
+    }
+
+    firmware.stop();
+    VirtualFirmwareStatistics stats = firmware.statistics();
+    std::printf("Zeilen: %llu, Bewegungen: %llu, Planer-Unterläufe: %llu, RX-Überläufe: %llu\n",
+                static_cast<unsigned long long>(stats.linesProcessed),
+                static_cast<unsigned long long>(stats.movesExecuted),
+                static_cast<unsigned long long>(stats.plannerUnderruns),
+                static_cast<unsigned long long>(stats.rxOverflows));
+    return 0;
+}
@@ -0,0 +1,388 @@
+#include "virtual_firmware.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+namespace {
+// Lücken im Planer, nach denen weniger als diese Zeit neue Bewegungen
+// eintreffen, gelten als Unterlauf durch den Host (µs Simulationszeit)
+constexpr double UnderrunWindowUs = 100000.0;
+// Bits pro übertragenem Byte (8N1: Start + 8 Daten + Stopp)
+constexpr double BitsPerByte = 10.0;
+
+bool isMotionCommand(const std::string &line) {
+    return line.size() >= 2 && line[0] == 'G' && line[1] >= '0' && line[1] <= '4'
+        && (line.size() == 2 || line[2] == ' ');
+}
+}
+
+VirtualFirmware::VirtualFirmware(const VirtualFirmwareSettings &settings)
+    : config(settings)
+    , masterFd(-1)
+    , slaveFd(-1)
+    , running(false)
+    , transmitBudgetBytes(0.0)
+    , headRemainingUs(-1.0)
+    , position{}
+    , plannedPosition{}
+    , feedrate(3000.0)
+    , halted(false)
+    , hasExecutedMoves(false)
+    , statusQueries(0)
+    , autoReportIntervalUs(0.0)
+    , bytesReceived(0)
+    , linesProcessed(0)
+    , movesExecuted(0)
+    , plannerUnderruns(0)
+    , rxOverflows(0)
+    , haltedFlag(false)
+{
+    config.timeScale = std::max(0.001, config.timeScale);
+    config.plannerQueueSize = std::max(1, config.plannerQueueSize);
+}
+
+VirtualFirmware::~VirtualFirmware() {
+    stop();
+}
+
+bool VirtualFirmware::start() {
+    if (running) return true;
+
+    masterFd = posix_openpt(O_RDWR | O_NOCTTY);
+    if (masterFd < 0 || grantpt(masterFd) != 0 || unlockpt(masterFd) != 0) {
+        std::perror("Pseudo-Terminal konnte nicht angelegt werden");
+        stop();
+        return false;
+    }
+
+    char name[128];
+    if (ptsname_r(masterFd, name, sizeof(name)) != 0) {
+        std::perror("Name des Pseudo-Terminals unbekannt");
+        stop();
+        return false;
+    }
+    slaveName = name;
+
+    // Eigene Slave-Seite offen halten, damit das Schließen durch den Host
+    // nicht zu EIO auf der Master-Seite führt; außerdem Rohmodus setzen
+    slaveFd = open(name, O_RDWR | O_NOCTTY);
+    if (slaveFd >= 0) {
+        termios tio;
+        if (tcgetattr(slaveFd, &tio) == 0) {
+            cfmakeraw(&tio);
+            tcsetattr(slaveFd, TCSANOW, &tio);
+        }
+    }
+
+    auto now = Clock::now();
+    nextLineTime = now;
+    plannerEmptySince = now;
+    running = true;
+    worker = std::thread(&VirtualFirmware::run, this);
+    return true;
+}
+
+void VirtualFirmware::stop() {
+    running = false;
+    if (worker.joinable()) {
+        worker.join();
+    }
+    if (slaveFd >= 0) {
+        close(slaveFd);
+        slaveFd = -1;
+    }
+    if (masterFd >= 0) {
+        close(masterFd);
+        masterFd = -1;
+    }
+}
+
+std::string VirtualFirmware::portName() const {
+    return slaveName;
+}
+
+VirtualFirmwareStatistics VirtualFirmware::statistics() const {
+    VirtualFirmwareStatistics stats;
+    stats.bytesReceived = bytesReceived.load();
+    stats.linesProcessed = linesProcessed.load();
+    stats.movesExecuted = movesExecuted.load();
+    stats.plannerUnderruns = plannerUnderruns.load();
+    stats.rxOverflows = rxOverflows.load();
+    stats.halted = haltedFlag.load();
+    return stats;
+}
+
+void VirtualFirmware::run() {
+    auto last = Clock::now();
+    char buffer[4096];
+
+    while (running) {
+        pollfd fd{masterFd, POLLIN, 0};
+        if (poll(&fd, 1, 1) > 0 && (fd.revents & POLLIN)) {
+            ssize_t received = read(masterFd, buffer, sizeof(buffer));
+            if (received > 0) {
+                // '?' ist ein Echtzeitbefehl und belegt keinen Empfangspuffer
+                for (ssize_t i = 0; i < received; ++i) {
+                    if (buffer[i] == '?') statusQueries++;
+                    else lineBuffer.push_back(buffer[i]);
+                }
+                bytesReceived += std::uint64_t(received);
+            }
+        }
+
+        auto now = Clock::now();
+        double elapsedUs = std::chrono::duration<double, std::micro>(now - last).count()
+                         * config.timeScale;
+        last = now;
+
+        receiveBytes(elapsedUs);
+        processLines(now);
+        executePlanner(elapsedUs, now);
+        sendPositionReports(now);
+    }
+}
+
+void VirtualFirmware::receiveBytes(double elapsedUs) {
+    // Bytes mit der eingestellten Übertragungsrate in den Empfangspuffer übernehmen
+    double bytesPerUs = config.baudRate / BitsPerByte / 1e6;
+    transmitBudgetBytes = std::min(transmitBudgetBytes + elapsedUs * bytesPerUs,
+                                   double(config.rxBufferSize));
+
+    auto transferable = std::min(lineBuffer.size(), size_t(transmitBudgetBytes));
+    if (transferable == 0) return;
+
+    rxBuffer.append(lineBuffer, 0, transferable);
+    lineBuffer.erase(0, transferable);
+    transmitBudgetBytes -= double(transferable);
+
+    // Ein korrekt zählender Host läuft nie über; echte Firmware verlöre die Bytes
+    if (rxBuffer.size() > size_t(config.rxBufferSize)) {
+        rxOverflows += rxBuffer.size() - size_t(config.rxBufferSize);
+    }
+}
+
+void VirtualFirmware::processLines(Clock::time_point now) {
+    if (halted) {
+        rxBuffer.clear();
+        lineBuffer.clear();
+        return;
+    }
+
+    // Not-Aus wird wie bei Marlins Emergency Parser sofort beim Empfang ausgewertet
+    if (rxBuffer.find("M112") != std::string::npos) {
+        handleLine("M112");
+        return;
+    }
+
+    while (now >= nextLineTime) {
+        size_t newline = rxBuffer.find('\n');
+        if (newline == std::string::npos) return;
+
+        std::string line = rxBuffer.substr(0, newline);
+        line.erase(std::min(line.find(';'), line.size()));
+        while (!line.empty() && (line.back() == '\r' || line.back() == ' ')) line.pop_back();
+
+        // Bewegungen werden erst übernommen (und bestätigt), wenn der Planer Platz hat
+        if (isMotionCommand(line) && int(planner.size()) >= config.plannerQueueSize) {
+            return;
+        }
+
+        rxBuffer.erase(0, newline + 1);
+        handleLine(line);
+        linesProcessed++;
+
+        auto processing = std::chrono::duration<double, std::micro>(
+            config.lineProcessingUs / config.timeScale);
+        nextLineTime = now + std::chrono::duration_cast<Clock::duration>(processing);
+    }
+}
+
+void VirtualFirmware::executePlanner(double elapsedUs, Clock::time_point now) {
+    double remaining = elapsedUs;
+
+    while (!planner.empty() && remaining > 0.0) {
+        if (headRemainingUs < 0.0) {
+            headRemainingUs = planner.front().durationUs;
+        }
+
+        double step = std::min(remaining, headRemainingUs);
+        headRemainingUs -= step;
+        remaining -= step;
+
+        if (headRemainingUs <= 0.0) {
+            position = planner.front().target;
+            planner.pop_front();
+            headRemainingUs = -1.0;
+            movesExecuted++;
+            hasExecutedMoves = true;
+            if (planner.empty()) {
+                plannerEmptySince = now;
+            }
+        }
+    }
+}
+
+void VirtualFirmware::sendPositionReports(Clock::time_point now) {
+    if (halted) return;
+
+    char report[128];
+    AxisPosition current = currentPosition();
+    for (; statusQueries > 0; --statusQueries) {
+        std::snprintf(report, sizeof(report), "<%s|MPos:%.3f,%.3f,%.3f|FS:%.0f,0>",
+                      planner.empty() ? "Idle" : "Run",
+                      current[0], current[1], current[2], planner.empty() ? 0.0 : feedrate);
+        reply(report);
+    }
+
+    if (autoReportIntervalUs > 0.0 && now >= nextAutoReport) {
+        std::snprintf(report, sizeof(report), "X:%.2f Y:%.2f Z:%.2f E:0.00 Count X:0 Y:0 Z:0",
+                      current[0], current[1], current[2]);
+        reply(report);
+        auto interval = std::chrono::duration<double, std::micro>(
+            autoReportIntervalUs / config.timeScale);
+        nextAutoReport = now + std::chrono::duration_cast<Clock::duration>(interval);
+    }
+}
+
+VirtualFirmware::AxisPosition VirtualFirmware::currentPosition() const {
+    // Linear zwischen Start und Ziel der laufenden Bewegung interpolieren
+    if (planner.empty() || headRemainingUs < 0.0 || planner.front().durationUs <= 0.0) {
+        return position;
+    }
+
+    double done = 1.0 - headRemainingUs / planner.front().durationUs;
+    AxisPosition current;
+    for (int axis = 0; axis < VirtualFirmwareAxes; ++axis) {
+        current[axis] = position[axis] + (planner.front().target[axis] - position[axis]) * done;
+    }
+    return current;
+}
+
+void VirtualFirmware::handleLine(const std::string &line) {
+    if (line.empty()) {
+        reply("ok");
+        return;
+    }
+
+    if (line.rfind("M112", 0) == 0) {
+        halted = true;
+        haltedFlag = true;
+        planner.clear();
+        reply("echo:EMERGENCY STOP");
+        return;
+    }
+
+    if (line.rfind("G0", 0) == 0 && isMotionCommand(line)) {
+        queueMove(line, true);
+    } else if (isMotionCommand(line)) {
+        queueMove(line, false);
+    } else if (line.rfind("G28", 0) == 0) {
+        // Referenzfahrt nur für das Portal; die Bandachse behält ihre Stellung
+        plannedPosition[0] = plannedPosition[1] = plannedPosition[2] = 0.0;
+        planner.push_back(PlannerEntry{plannedPosition, 0.0});
+    } else if (line.rfind("M114", 0) == 0) {
+        // Dieselbe interpolierte Position wie '?' und der Autoreport
+        AxisPosition current = currentPosition();
+        char report[128];
+        std::snprintf(report, sizeof(report), "X:%.2f Y:%.2f Z:%.2f E:0.00 Count X:0 Y:0 Z:0",
+                      current[0], current[1], current[2]);
+        reply(report);
+    } else if (line.rfind("M154", 0) == 0) {
+        double seconds = 0.0;
+        parseWord(line, 'S', seconds);
+        autoReportIntervalUs = std::max(0.0, seconds) * 1e6;
+        nextAutoReport = Clock::now();
+    }
+
+    reply("ok");
+}
+
+void VirtualFirmware::queueMove(const std::string &line, bool rapid) {
+    auto now = Clock::now();
+    if (planner.empty() && hasExecutedMoves) {
+        double idleUs = std::chrono::duration<double, std::micro>(now - plannerEmptySince).count()
+                      * config.timeScale;
+        if (idleUs < UnderrunWindowUs) {
+            plannerUnderruns++;
+        }
+    }
+
+    double value;
+    if (parseWord(line, 'F', value) && value > 0.0) {
+        feedrate = value;
+    }
+    double speed = (rapid ? std::max(feedrate, 6000.0) : feedrate) / 60.0; // mm/s
+
+    int code = line[1] - '0';
+    if (code == 4) {
+        // Verweilzeit belegt einen Planer-Eintrag
+        double dwellUs = 0.0;
+        if (parseWord(line, 'P', value)) dwellUs = value * 1000.0;
+        else if (parseWord(line, 'S', value)) dwellUs = value * 1e6;
+        planner.push_back(PlannerEntry{plannedPosition, dwellUs});
+        return;
+    }
+
+    AxisPosition target = plannedPosition;
+    const char axes[VirtualFirmwareAxes] = {'X', 'Y', 'Z', 'A'};
+    for (int axis = 0; axis < VirtualFirmwareAxes; ++axis) {
+        if (parseWord(line, axes[axis], value)) target[axis] = value;
+    }
+
+    double length = 0.0;
+    if (code == 2 || code == 3) {
+        // Bogenlänge aus Mittelpunkt (I, J) und Drehsinn
+        double i = 0.0;
+        double j = 0.0;
+        parseWord(line, 'I', i);
+        parseWord(line, 'J', j);
+        double centerX = plannedPosition[0] + i;
+        double centerY = plannedPosition[1] + j;
+        double radius = std::hypot(i, j);
+        double startAngle = std::atan2(-j, -i);
+        double endAngle = std::atan2(target[1] - centerY, target[0] - centerX);
+        double sweep = endAngle - startAngle;
+        if (code == 2 && sweep >= 0.0) sweep -= 2.0 * M_PI;
+        if (code == 3 && sweep <= 0.0) sweep += 2.0 * M_PI;
+        length = std::hypot(radius * std::abs(sweep), target[2] - plannedPosition[2]);
+    } else {
+        // Vorschub gilt wie bei Marlin für den Weg über alle linearen Achsen
+        double lengthSquared = 0.0;
+        for (int axis = 0; axis < VirtualFirmwareAxes; ++axis) {
+            lengthSquared += std::pow(target[axis] - plannedPosition[axis], 2);
+        }
+        length = std::sqrt(lengthSquared);
+    }
+
+    planner.push_back(PlannerEntry{target, length / speed * 1e6});
+    plannedPosition = target;
+}
+
+void VirtualFirmware::reply(const std::string &text) {
+    std::string data = text + "\n";
+    size_t offset = 0;
+    while (offset < data.size()) {
+        ssize_t written = write(masterFd, data.data() + offset, data.size() - offset);
+        if (written <= 0) return;
+        offset += size_t(written);
+    }
+}
+
+bool VirtualFirmware::parseWord(const std::string &line, char letter, double &value) {
+    // Wort am Zeilenanfang oder nach einem Leerzeichen suchen (z.B. " X12.5")
+    for (size_t pos = line.find(letter); pos != std::string::npos; pos = line.find(letter, pos + 1)) {
+        if (pos != 0 && line[pos - 1] != ' ') continue;
+        char *end = nullptr;
+        double parsed = std::strtod(line.c_str() + pos + 1, &end);
+        if (end != line.c_str() + pos + 1) {
+            value = parsed;
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,102 @@
+#ifndef SOLDERROBOT_VIRTUAL_FIRMWARE_H
+#define SOLDERROBOT_VIRTUAL_FIRMWARE_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <thread>
+
+// X, Y, Z und die Förderbandachse A
+constexpr int VirtualFirmwareAxes = 4;
+
+struct VirtualFirmwareSettings {
+    int baudRate = 115200;          // Übertragungsrate der simulierten Leitung
+    int rxBufferSize = 128;         // Empfangspuffer in Bytes (Grbl/Marlin: 128)
+    int plannerQueueSize = 16;      // Einträge im Bewegungsplaner
+    int lineProcessingUs = 200;     // Rechenzeit der Firmware pro Zeile bis zum "ok"
+    double timeScale = 1.0;         // > 1: schneller als Echtzeit
+};
+
+struct VirtualFirmwareStatistics {
+    std::uint64_t bytesReceived = 0;
+    std::uint64_t linesProcessed = 0;
+    std::uint64_t movesExecuted = 0;
+    std::uint64_t plannerUnderruns = 0;  // Planer lief leer, obwohl weitere Bewegungen folgten
+    std::uint64_t rxOverflows = 0;       // Bytes jenseits des Empfangspuffers (Fehler im Host)
+    bool halted = false;                 // Nach M112
+};
+
+// Marlin/Grbl-ähnliche Firmware-Attrappe auf einem Pseudo-Terminal.
+//
+// Modelliert werden die Übertragungsrate, ein begrenzter Empfangspuffer, eine
+// Planer-Warteschlange mit Ausführungszeiten aus Weg und Vorschub, das "ok"
+// nach Übernahme einer Zeile in den Planer sowie M114, M154 (Autoreport der
+// Position), die Grbl-Statusabfrage '?' und M112. Der Host verbindet sich
+// über portName() wie mit einem echten seriellen Gerät.
+class VirtualFirmware {
+public:
+    explicit VirtualFirmware(const VirtualFirmwareSettings &settings = VirtualFirmwareSettings());
+    ~VirtualFirmware();
+
+    bool start();
+    void stop();
+
+    std::string portName() const;
+    VirtualFirmwareStatistics statistics() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+    using AxisPosition = std::array<double, VirtualFirmwareAxes>;
+
+    struct PlannerEntry {
+        AxisPosition target;
+        double durationUs;
+    };
+
+    void run();
+    void receiveBytes(double elapsedUs);
+    void processLines(Clock::time_point now);
+    void executePlanner(double elapsedUs, Clock::time_point now);
+    void handleLine(const std::string &line);
+    void queueMove(const std::string &line, bool rapid);
+    void sendPositionReports(Clock::time_point now);
+    AxisPosition currentPosition() const;
+    void reply(const std::string &text);
+    static bool parseWord(const std::string &line, char letter, double &value);
+
+    VirtualFirmwareSettings config;
+    int masterFd;
+    int slaveFd;
+    std::string slaveName;
+    std::thread worker;
+    std::atomic<bool> running;
+
+    // Zustand des Firmware-Threads
+    std::string lineBuffer;        // Vom Host geschrieben, noch "auf der Leitung"
+    std::string rxBuffer;          // Im Empfangspuffer der Firmware
+    double transmitBudgetBytes;
+    Clock::time_point nextLineTime;
+    Clock::time_point plannerEmptySince;
+    std::deque<PlannerEntry> planner;
+    double headRemainingUs;
+    AxisPosition position;
+    AxisPosition plannedPosition;
+    double feedrate;               // mm/min
+    bool halted;
+    bool hasExecutedMoves;
+    int statusQueries;             // Empfangene '?', noch unbeantwortet
+    double autoReportIntervalUs;   // M154; 0 = aus
+    Clock::time_point nextAutoReport;
+
+    std::atomic<std::uint64_t> bytesReceived;
+    std::atomic<std::uint64_t> linesProcessed;
+    std::atomic<std::uint64_t> movesExecuted;
+    std::atomic<std::uint64_t> plannerUnderruns;
+    std::atomic<std::uint64_t> rxOverflows;
+    std::atomic<bool> haltedFlag;
+};
+
+#endif // SOLDERROBOT_VIRTUAL_FIRMWARE_H